@@ -8,9 +8,38 @@
 #include <limits>
 #include <algorithm> // std::remove_if
 #include <climits>   // INT_MIN, INT_MAX
+#include <list>
+#include <thread>
+#include <chrono>
+#include <cstdio> // rename, remove
+#include <map>
+#include <queue>
+#include <ctime>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <mutex>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
+// Upper bound on patients + doctors + appointments kept in memory across
+// all loaded hospitals; least recently managed hospitals are evicted first.
+const size_t LOADED_RECORD_BUDGET = 500000;
+
+// Write-ahead log tuning: buffered registrations are written together once
+// either limit is hit, and the log is folded back into the CSVs in the
+// background after WAL_COMPACT_RECORDS entries.
+const size_t WAL_GROUP_COMMIT_RECORDS = 64;
+const int WAL_GROUP_COMMIT_MS = 200;
+const size_t WAL_COMPACT_RECORDS = 5000;
+
 // ======== Utility: Safe Integer Input ========
 int readInt(const string &prompt, int minVal = INT_MIN, int maxVal = INT_MAX)
 {
@@ -43,179 +72,1266 @@ int readInt(const string &prompt, int minVal = INT_MIN, int maxVal = INT_MAX)
     }
 }
 
+// Whole-string integer parse for stored rows; false on empty, junk or overflow
+bool parseInt(const string &s, int &out)
+{
+    if (s.empty())
+        return false;
+    char *end;
+    errno = 0;
+    long v = strtol(s.c_str(), &end, 10);
+    if (*end || errno || v < INT_MIN || v > INT_MAX)
+        return false;
+    out = (int)v;
+    return true;
+}
+
+string toLowerStr(const string &s)
+{
+    string out = s;
+    transform(out.begin(), out.end(), out.begin(), ::tolower);
+    return out;
+}
+
+// ======== Utility: Compact Date-Times ========
+// Appointment dates ("YYYY-MM-DD HH:MM", time optional) are kept as minutes
+// since 2000-01-01 00:00 so schedules can be ordered and compared as ints.
+const int APPOINTMENT_MINUTES = 30;
+
+int daysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 730425; // 730425 = days from 0000-03-01 to 2000-01-01
+}
+
+bool parseDateParts(const string &text, int &y, int &mo, int &d, int &h, int &mi)
+{
+    h = mi = 0;
+    char sep1, sep2;
+    stringstream ss(text);
+    if (!(ss >> y >> sep1 >> mo >> sep2 >> d) || sep1 != '-' || sep2 != '-')
+        return false;
+    char colon;
+    if (ss >> h && !(ss >> colon >> mi && colon == ':'))
+        return false;
+    int daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if ((y % 4 == 0 && y % 100 != 0) || y % 400 == 0)
+        daysInMonth[1] = 29;
+    return y >= 1 && mo >= 1 && mo <= 12 && d >= 1 && d <= daysInMonth[mo - 1] &&
+           h >= 0 && h <= 23 && mi >= 0 && mi <= 59;
+}
+
+// Returns -1 when the text isn't a valid date
+int parseDateTime(const string &text)
+{
+    int y, mo, d, h, mi;
+    if (!parseDateParts(text, y, mo, d, h, mi) || y < 2000)
+        return -1;
+    return daysFromCivil(y, mo, d) * 1440 + h * 60 + mi;
+}
+
+// Days since 2000-01-01 (negative before), INT_MIN when not a date; for DOBs
+int parseDay(const string &text)
+{
+    int y, mo, d, h, mi;
+    if (!parseDateParts(text, y, mo, d, h, mi))
+        return INT_MIN;
+    return daysFromCivil(y, mo, d);
+}
+
+string formatDateTime(int minutes)
+{
+    int z = minutes / 1440 + 730425; // back to days since 0000-03-01
+    int era = z / 146097, doe = z - era * 146097;
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    int d = doy - (153 * mp + 2) / 5 + 1, m = mp + (mp < 10 ? 3 : -9);
+    int y = yoe + era * 400 + (m <= 2);
+    char buf[40];
+    snprintf(buf, sizeof buf, "%04d-%02d-%02d %02d:%02d", y, m, d,
+             minutes % 1440 / 60, minutes % 60);
+    return buf;
+}
+
 // ======== Data Structures ========
 struct Patient
 {
     int id;
     string name, dob, gender;
-    Patient *next;
 };
 struct Doctor
 {
     int id;
     string name, specialization;
-    Doctor *next;
 };
 struct Appointment
 {
     int id, patientId, doctorId;
     string date;
-    Appointment *next;
+    int start; // parseDateTime(date), -1 for legacy free-form dates
+};
+
+// ======== Record Store: contiguous records + ID hash index ========
+// Records stay in insertion order for display and saving; pointers returned
+// by find() are only valid until the next add().
+template <typename T>
+class RecordStore
+{
+public:
+    vector<T> records;
+    unordered_map<int, size_t> index; // id -> position in records
+
+    T *find(int id)
+    {
+        auto it = index.find(id);
+        return it == index.end() ? nullptr : &records[it->second];
+    }
+    T &add(const T &rec)
+    {
+        index[rec.id] = records.size();
+        records.push_back(rec);
+        return records.back();
+    }
+    void reserve(size_t n)
+    {
+        records.reserve(n);
+        index.reserve(n);
+    }
+    // Releases the whole store in one go (swap, so capacity is returned too)
+    void clear()
+    {
+        vector<T>().swap(records);
+        unordered_map<int, size_t>().swap(index);
+    }
+    size_t size() const { return records.size(); }
+    typename vector<T>::iterator begin() { return records.begin(); }
+    typename vector<T>::iterator end() { return records.end(); }
+};
+
+// ======== Columnar Analytics View ========
+// Structure-of-arrays copy of a hospital's records for group-by reports:
+// strings are dictionary-encoded and dates kept as day numbers, so each
+// report is a tight loop over one or two small integer columns.
+struct Dictionary
+{
+    vector<string> values;
+    unordered_map<string, int> codes;
+
+    int encode(const string &v)
+    {
+        auto it = codes.find(v);
+        if (it != codes.end())
+            return it->second;
+        codes[v] = values.size();
+        values.push_back(v);
+        return values.size() - 1;
+    }
+};
+
+struct HospitalColumns
+{
+    Dictionary genders, specializations;
+    vector<uint8_t> patientGender;
+    vector<int> patientBirthDay;     // parseDay(dob), INT_MIN if unknown
+    vector<uint16_t> doctorSpec;
+    vector<int> apptDoctor, apptDay; // apptDay is -1 for free-form dates
+
+    void addPatient(const Patient &p)
+    {
+        patientGender.push_back(genders.encode(toLowerStr(p.gender)));
+        patientBirthDay.push_back(parseDay(p.dob));
+    }
+    void addDoctor(const Doctor &d)
+    {
+        doctorSpec.push_back(specializations.encode(toLowerStr(d.specialization)));
+    }
+    void addAppointment(const Appointment &a)
+    {
+        apptDoctor.push_back(a.doctorId);
+        apptDay.push_back(a.start < 0 ? -1 : a.start / 1440);
+    }
+    void clear() { *this = HospitalColumns(); }
+
+    vector<int> countByCode(const vector<uint8_t> &col, size_t n) const
+    {
+        vector<int> counts(n);
+        for (size_t i = 0; i < col.size(); ++i)
+            counts[col[i]]++;
+        return counts;
+    }
+    vector<int> countByCode(const vector<uint16_t> &col, size_t n) const
+    {
+        vector<int> counts(n);
+        for (size_t i = 0; i < col.size(); ++i)
+            counts[col[i]]++;
+        return counts;
+    }
+    // Bands: 0-17, 18-34, 35-49, 50-64, 65+, unknown
+    vector<int> ageBands(int today) const
+    {
+        static const int limits[] = {18, 35, 50, 65};
+        vector<int> counts(6);
+        for (size_t i = 0; i < patientBirthDay.size(); ++i)
+        {
+            int born = patientBirthDay[i];
+            if (born == INT_MIN || born > today)
+            {
+                counts[5]++;
+                continue;
+            }
+            int age = (long long)(today - born) * 400 / 146097; // whole years
+            int band = 0;
+            while (band < 4 && age >= limits[band])
+                band++;
+            counts[band]++;
+        }
+        return counts;
+    }
+    vector<int> appointmentsPerDoctor(int maxDoctorId) const
+    {
+        vector<int> counts(maxDoctorId + 1);
+        for (size_t i = 0; i < apptDoctor.size(); ++i)
+            if (apptDoctor[i] >= 0 && apptDoctor[i] <= maxDoctorId)
+                counts[apptDoctor[i]]++;
+        return counts;
+    }
+    // Dense per-day histogram starting at firstDay
+    vector<int> appointmentsPerDay(int &firstDay) const
+    {
+        int lo = INT_MAX, hi = INT_MIN;
+        for (int d : apptDay)
+            if (d >= 0)
+            {
+                lo = min(lo, d);
+                hi = max(hi, d);
+            }
+        firstDay = lo;
+        if (lo > hi)
+            return {};
+        vector<int> counts(hi - lo + 1);
+        for (size_t i = 0; i < apptDay.size(); ++i)
+            if (apptDay[i] >= 0)
+                counts[apptDay[i] - lo]++;
+        return counts;
+    }
 };
 
+// ======== Segmented Data File ========
+// Optional replacement for the three CSVs per hospital: one file holding a
+// segment per hospital (the same CSV text, in sections) plus a directory of
+// fixed-size entries. Each hospital owns two equal regions: the live segment
+// and a shadow. A rewrite goes to the shadow and is synced before the
+// directory entry is flipped to it, so a crash leaves either the old or the
+// new segment, never a torn one. A segment that outgrows its regions moves
+// to the end of the file and only its entry is rewritten. The directory has
+// its own region with room to spare and moves (doubling) only when full.
+// On POSIX the file is mmap'ed for reads.
+const string DATA_FILE = "hospital_data.dat";
+
+class SegmentFile
+{
+public:
+    const string path;
+
+    explicit SegmentFile(const string &p) : path(p) { open(); }
+    ~SegmentFile() { unmap(); }
+
+    static bool exists(const string &p) { return ifstream(p).good(); }
+    static void create(const string &p)
+    {
+        ofstream f(p, ios::binary | ios::trunc);
+        Header h = {{'H', 'M', 'S', 'S', 'E', 'G', '0', '1'}, DIR_START, 0, INITIAL_DIR_CAPACITY};
+        f.write((const char *)&h, sizeof h);
+    }
+
+    bool has(const string &hid)
+    {
+        lock_guard<mutex> g(lock);
+        return slotOf.count(hid) > 0;
+    }
+    string read(const string &hid)
+    {
+        lock_guard<mutex> g(lock);
+        auto it = slotOf.find(hid);
+        if (it == slotOf.end())
+            return "";
+        const DirEntry &e = dir[it->second];
+        if (mapped && e.offset + e.length <= mappedSize)
+            return string(mapped + e.offset, e.length);
+        string out(e.length, '\0');
+        ifstream f(path, ios::binary);
+        f.seekg(e.offset);
+        f.read(&out[0], e.length);
+        return out;
+    }
+    void write(const string &hid, const string &data)
+    {
+        lock_guard<mutex> g(lock);
+        {
+            fstream f(path, ios::in | ios::out | ios::binary);
+            place(f, hid, data);
+        }
+        if (!batching)
+            commitEntries();
+    }
+    // Between these, writes only lay down segment bytes; the directory is
+    // written (and the file synced and remapped) once at the end
+    void beginBatch()
+    {
+        lock_guard<mutex> g(lock);
+        batching = true;
+    }
+    void endBatch()
+    {
+        lock_guard<mutex> g(lock);
+        batching = false;
+        commitEntries();
+    }
+    // Blanks the directory entry for reuse; the segment's bytes become dead space
+    void erase(const string &hid)
+    {
+        lock_guard<mutex> g(lock);
+        auto it = slotOf.find(hid);
+        if (it == slotOf.end())
+            return;
+        DirEntry &e = dir[it->second];
+        memset(e.id, 0, sizeof e.id);
+        if (it->second < header.dirCount)
+        {
+            fstream f(path, ios::in | ios::out | ios::binary);
+            f.seekp(header.dirOffset + it->second * sizeof(DirEntry));
+            f.write((const char *)&e, sizeof e);
+        }
+        freeSlots.push_back(it->second);
+        slotOf.erase(it);
+    }
+
+private:
+    struct Header
+    {
+        char magic[8];
+        uint64_t dirOffset, dirCount, dirCapacity;
+    };
+    // 64 bytes, and the directory starts 64-aligned, so an entry never
+    // straddles a disk sector and flipping it is a single sector write
+    struct DirEntry
+    {
+        char id[24];
+        uint64_t offset, length, capacity, spare, reserved;
+    };
+    static constexpr uint64_t DIR_START = 64;
+    static constexpr uint64_t INITIAL_DIR_CAPACITY = 64;
+
+    Header header = {};
+    vector<DirEntry> dir;
+    unordered_map<string, size_t> slotOf; // hospital ID -> directory index
+    vector<size_t> freeSlots;             // blanked entries, reused first
+    unordered_set<size_t> pending;        // entries changed since the last commit
+    bool batching = false;
+    uint64_t fileEnd = DIR_START;
+    mutex lock; // compaction threads of different hospitals share the file
+    const char *mapped = nullptr;
+    size_t mappedSize = 0;
+
+    void open()
+    {
+        ifstream f(path, ios::binary);
+        f.read((char *)&header, sizeof header);
+        if (!f || memcmp(header.magic, "HMSSEG01", 8) != 0 || header.dirCount > header.dirCapacity)
+        {
+            cerr << path << " is not a hospital data file.\n";
+            header = {};
+            return;
+        }
+        dir.resize(header.dirCount);
+        f.seekg(header.dirOffset);
+        f.read((char *)dir.data(), dir.size() * sizeof(DirEntry));
+        f.close();
+        fileEnd = header.dirOffset + header.dirCapacity * sizeof(DirEntry);
+        for (size_t i = 0; i < dir.size(); ++i)
+        {
+            if (!dir[i].id[0])
+            {
+                freeSlots.push_back(i);
+                continue;
+            }
+            fileEnd = max(fileEnd, dir[i].offset + dir[i].capacity);
+            fileEnd = max(fileEnd, dir[i].spare + dir[i].capacity);
+            slotOf[string(dir[i].id)] = i;
+        }
+        remap();
+    }
+
+    // Lays down the segment bytes and updates the in-memory entry. A segment
+    // that fits goes to its shadow region (unless that entry already changed
+    // in this batch: its shadow is then what the disk directory points at)
+    void place(fstream &f, const string &hid, const string &data)
+    {
+        auto it = slotOf.find(hid);
+        if (it != slotOf.end() && !pending.count(it->second) && data.size() <= dir[it->second].capacity)
+        {
+            DirEntry &e = dir[it->second];
+            f.seekp(e.spare);
+            f.write(data.data(), data.size());
+            swap(e.offset, e.spare);
+            e.length = data.size();
+            pending.insert(it->second);
+            return;
+        }
+        DirEntry e = {};
+        hid.copy(e.id, sizeof e.id - 1);
+        e.offset = fileEnd;
+        e.length = data.size();
+        e.capacity = data.size() + data.size() / 2 + 512;
+        e.spare = e.offset + e.capacity;
+        string padded = data;
+        padded.resize(2 * e.capacity, '\0');
+        f.seekp(e.offset);
+        f.write(padded.data(), padded.size());
+        fileEnd = e.spare + e.capacity;
+        size_t slot;
+        if (it != slotOf.end())
+            slot = it->second;
+        else if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            slot = dir.size();
+            dir.push_back({});
+        }
+        dir[slot] = e;
+        slotOf[hid] = slot;
+        pending.insert(slot);
+    }
+
+    // Syncs the segment bytes, then writes the changed entries in place and
+    // bumps the header's count; a full directory moves to a bigger region
+    void commitEntries()
+    {
+        if (pending.empty())
+            return;
+        syncFile();
+        fstream f(path, ios::in | ios::out | ios::binary);
+        if (dir.size() > header.dirCapacity)
+            moveDirectory(f);
+        else
+        {
+            for (size_t slot : pending)
+            {
+                f.seekp(header.dirOffset + slot * sizeof(DirEntry));
+                f.write((const char *)&dir[slot], sizeof(DirEntry));
+            }
+            if (dir.size() > header.dirCount)
+            {
+                f.flush();
+                syncFile();
+                header.dirCount = dir.size();
+                f.seekp(0);
+                f.write((const char *)&header, sizeof header);
+            }
+        }
+        f.flush();
+        f.close();
+        syncFile();
+        pending.clear();
+        remap();
+    }
+
+    // Writes the directory to a new region at the end with double the
+    // entries, syncs it, then points the header at it
+    void moveDirectory(fstream &f)
+    {
+        uint64_t capacity = max<uint64_t>(header.dirCapacity, INITIAL_DIR_CAPACITY);
+        while (capacity < dir.size())
+            capacity *= 2;
+        capacity *= 2;
+        header.dirOffset = (fileEnd + 63) / 64 * 64;
+        header.dirCount = dir.size();
+        header.dirCapacity = capacity;
+        f.seekp(header.dirOffset);
+        f.write((const char *)dir.data(), dir.size() * sizeof(DirEntry));
+        f.flush();
+        syncFile();
+        fileEnd = header.dirOffset + capacity * sizeof(DirEntry);
+        f.seekp(0);
+        f.write((const char *)&header, sizeof header);
+    }
+
+#ifdef _WIN32
+    void remap() {} // reads fall back to seek + read
+    void unmap() {}
+    void syncFile() {}
+#else
+    // Pushes everything written so far to disk before the next step depends on it
+    void syncFile()
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        fsync(fd);
+        close(fd);
+    }
+    void remap()
+    {
+        unmap();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                mapped = (const char *)p;
+                mappedSize = st.st_size;
+            }
+        }
+        close(fd);
+    }
+    void unmap()
+    {
+        if (mapped)
+            munmap((void *)mapped, mappedSize);
+        mapped = nullptr;
+        mappedSize = 0;
+    }
+#endif
+};
+
+// Set when hospital_data.dat is in use; otherwise hospitals use their CSVs
+SegmentFile *segmentStore = nullptr;
+
 // ======== Hospital Class ========
 class Hospital
 {
 public:
     string hospitalId, name, location;
-    Patient *patients = nullptr;
-    Doctor *doctors = nullptr;
-    Appointment *appointments = nullptr;
+    RecordStore<Patient> patients;
+    RecordStore<Doctor> doctors;
+    RecordStore<Appointment> appointments;
+    HospitalColumns columns; // analytical view, kept in step with the stores
 
     int nextPatientId = 1;
     int nextDoctorId = 1;
     int nextAppointmentId = 1;
 
+    // Records are read from disk on first access, not at construction
+    bool loaded = false;
+
+    // Registrations are appended to <id>_wal.log instead of rewriting the CSVs
+    string walBuffer;
+    size_t walPending = 0, walRecords = 0;
+    chrono::steady_clock::time_point walFirstPending;
+    thread compactor;
+
     Hospital() = default;
     Hospital(const string &id, const string &nm, const string &loc)
-        : hospitalId(id), name(nm), location(loc)
+        : hospitalId(id), name(nm), location(loc) {}
+    ~Hospital() { unload(); }
+
+    size_t recordCount() const
+    {
+        return patients.size() + doctors.size() + appointments.size();
+    }
+
+    void ensureLoaded()
     {
+        if (loaded)
+            return;
         loadData();
         normalizeCounters();
+        for (auto &p : patients)
+            columns.addPatient(p);
+        for (auto &d : doctors)
+            columns.addDoctor(d);
+        for (auto &a : appointments)
+        {
+            scheduleAppointment(a);
+            columns.addAppointment(a);
+        }
+        loaded = true;
+    }
+    // Commits the log first, so dropping the records is safe
+    void unload()
+    {
+        commitLog();
+        if (compactor.joinable())
+            compactor.join();
+        patients.clear();
+        doctors.clear();
+        appointments.clear();
+        schedule.clear();
+        timeline.clear();
+        columns.clear();
+        nextPatientId = nextDoctorId = nextAppointmentId = 1;
+        loaded = false;
+    }
+
+    // For a deleted hospital: drops unwritten registrations, waits out any
+    // compaction and removes the files, so a later hospital reusing the id
+    // starts empty
+    void discard()
+    {
+        walBuffer.clear();
+        walPending = 0;
+        if (compactor.joinable())
+            compactor.join();
+        remove(walPath().c_str());
+        remove((walPath() + ".old").c_str());
+        if (!segmentStore)
+        {
+            remove((hospitalId + "_patients.csv").c_str());
+            remove((hospitalId + "_doctors.csv").c_str());
+            remove((hospitalId + "_appointments.csv").c_str());
+        }
     }
 
     int registerPatient(const string &n, const string &d, const string &g)
     {
         int id = nextPatientId++;
-        patients = new Patient{id, n, d, g, patients};
-        saveData();
+        columns.addPatient(patients.add({id, n, d, g}));
+        logRecord("P," + to_string(id) + ',' + n + ',' + d + ',' + g);
         return id;
     }
     int registerDoctor(const string &n, const string &spec)
     {
         int id = nextDoctorId++;
-        doctors = new Doctor{id, n, spec, doctors};
-        saveData();
+        columns.addDoctor(doctors.add({id, n, spec}));
+        logRecord("D," + to_string(id) + ',' + n + ',' + spec);
         return id;
     }
+    // -1: unknown patient/doctor, -2: doctor already booked, -3: bad date
     int registerAppointment(int pid, int did, const string &dt)
     {
         if (!findPatient(pid) || !findDoctor(did))
             return -1;
+        int start = parseDateTime(dt);
+        if (start < 0)
+            return -3;
+        if (!isDoctorFree(did, start))
+            return -2;
         int id = nextAppointmentId++;
-        appointments = new Appointment{id, pid, did, dt, appointments};
-        saveData();
+        appointments.add({id, pid, did, dt, start});
+        scheduleAppointment(appointments.records.back());
+        columns.addAppointment(appointments.records.back());
+        logRecord("A," + to_string(id) + ',' + to_string(pid) + ',' + to_string(did) + ',' + dt);
         return id;
     }
 
+    // --- Doctor schedules: each appointment blocks [start, start + 30min) ---
+    bool hasDoctor(int did) { return findDoctor(did) != nullptr; }
+    bool isDoctorFree(int did, int t) const
+    {
+        auto d = schedule.find(did);
+        if (d == schedule.end())
+            return true;
+        auto it = d->second.upper_bound(t - APPOINTMENT_MINUTES);
+        return it == d->second.end() || it->first >= t + APPOINTMENT_MINUTES;
+    }
+    // Skips over back-to-back bookings, one O(log n) probe per booking
+    int nextFreeSlot(int did, int t) const
+    {
+        auto d = schedule.find(did);
+        if (d == schedule.end())
+            return t;
+        const map<int, int> &slots = d->second;
+        while (true)
+        {
+            auto it = slots.upper_bound(t - APPOINTMENT_MINUTES);
+            if (it == slots.end() || it->first >= t + APPOINTMENT_MINUTES)
+                return t;
+            t = it->first + APPOINTMENT_MINUTES;
+        }
+    }
+    void displayAppointmentsBetween(int from, int to)
+    {
+        cout << "-- Appointments from " << formatDateTime(from) << " to "
+             << formatDateTime(to) << " --\n";
+        for (auto it = timeline.lower_bound(from); it != timeline.end() && it->first < to; ++it)
+        {
+            Appointment *a = appointments.find(it->second);
+            cout << a->id << ": P" << a->patientId << " → D" << a->doctorId << " on " << a->date << "\n";
+        }
+    }
+
+    void displayReports()
+    {
+        cout << "-- Reports for " << name << " (" << hospitalId << ") --\n";
+        cout << "Patients by gender:\n";
+        auto byGender = columns.countByCode(columns.patientGender, columns.genders.values.size());
+        for (size_t i = 0; i < byGender.size(); ++i)
+            cout << "  " << columns.genders.values[i] << ": " << byGender[i] << "\n";
+
+        time_t now = time(0);
+        tm *lt = localtime(&now);
+        int today = daysFromCivil(lt->tm_year + 1900, lt->tm_mon + 1, lt->tm_mday);
+        static const char *bands[] = {"0-17", "18-34", "35-49", "50-64", "65+", "unknown"};
+        auto byAge = columns.ageBands(today);
+        cout << "Patients by age band:\n";
+        for (int i = 0; i < 6; ++i)
+            cout << "  " << bands[i] << ": " << byAge[i] << "\n";
+
+        cout << "Doctors by specialization:\n";
+        auto bySpec = columns.countByCode(columns.doctorSpec, columns.specializations.values.size());
+        for (size_t i = 0; i < bySpec.size(); ++i)
+            cout << "  " << columns.specializations.values[i] << ": " << bySpec[i] << "\n";
+
+        cout << "Appointments per doctor:\n";
+        auto perDoctor = columns.appointmentsPerDoctor(nextDoctorId - 1);
+        for (size_t did = 1; did < perDoctor.size(); ++did)
+            if (perDoctor[did])
+                cout << "  D" << did << ": " << perDoctor[did] << "\n";
+
+        cout << "Appointments per day:\n";
+        int firstDay;
+        auto perDay = columns.appointmentsPerDay(firstDay);
+        for (size_t i = 0; i < perDay.size(); ++i)
+            if (perDay[i])
+                cout << "  " << formatDateTime((firstDay + i) * 1440).substr(0, 10) << ": " << perDay[i] << "\n";
+    }
+
     void displayPatients()
     {
         cout << "-- Patients in " << name << " (" << hospitalId << ") --\n";
-        for (auto *p = patients; p; p = p->next)
-            cout << p->id << ": " << p->name << " | " << p->dob << " | " << p->gender << "\n";
+        for (auto &p : patients)
+            cout << p.id << ": " << p.name << " | " << p.dob << " | " << p.gender << "\n";
     }
     void displayDoctors()
     {
         cout << "-- Doctors in " << name << " (" << hospitalId << ") --\n";
-        for (auto *d = doctors; d; d = d->next)
-            cout << d->id << ": " << d->name << " | " << d->specialization << "\n";
+        for (auto &d : doctors)
+            cout << d.id << ": " << d.name << " | " << d.specialization << "\n";
     }
     void displayAppointments()
     {
         cout << "-- Appointments in " << name << " (" << hospitalId << ") --\n";
-        for (auto *a = appointments; a; a = a->next)
-            cout << a->id << ": P" << a->patientId << " → D" << a->doctorId << " on " << a->date << "\n";
+        for (auto &a : appointments)
+            cout << a.id << ": P" << a.patientId << " → D" << a.doctorId << " on " << a.date << "\n";
     }
 
     void loadData()
     {
-        loadList<Patient>(hospitalId + "_patients.csv", patients);
-        loadList<Doctor>(hospitalId + "_doctors.csv", doctors);
-        loadList<Appointment>(hospitalId + "_appointments.csv", appointments);
+        if (segmentStore)
+            loadSegment(segmentStore->read(hospitalId));
+        else
+        {
+            loadList<Patient>(hospitalId + "_patients.csv", patients);
+            loadList<Doctor>(hospitalId + "_doctors.csv", doctors);
+            loadList<Appointment>(hospitalId + "_appointments.csv", appointments);
+        }
+        // A leftover .old log means a compaction was interrupted; fold it in now
+        bool interrupted = replayLog(walPath() + ".old");
+        walRecords = replayLog(walPath()) ? countLines(walPath()) : 0;
+        if (interrupted)
+        {
+            saveData();
+            remove((walPath() + ".old").c_str());
+        }
     }
     void saveData()
     {
-        savePatients(hospitalId + "_patients.csv");
-        saveDoctors(hospitalId + "_doctors.csv");
-        saveAppointments(hospitalId + "_appointments.csv");
+        writeTables(hospitalId, patients.records, doctors.records, appointments.records);
+    }
+    // CSV export works in either storage mode
+    void exportCsv()
+    {
+        saveCsv(hospitalId + "_patients.csv", patientsCsv(patients.records));
+        saveCsv(hospitalId + "_doctors.csv", doctorsCsv(doctors.records));
+        saveCsv(hospitalId + "_appointments.csv", appointmentsCsv(appointments.records));
+    }
+    string segmentText()
+    {
+        return segmentOf(patients.records, doctors.records, appointments.records);
+    }
+
+    // Writes every buffered registration with a single append + flush
+    void commitLog()
+    {
+        if (walPending == 0)
+            return;
+        ofstream f(walPath(), ios::app);
+        f << walBuffer;
+        f.flush();
+        walBuffer.clear();
+        walRecords += walPending;
+        walPending = 0;
+        if (walRecords >= WAL_COMPACT_RECORDS)
+            startCompaction();
     }
 
 private:
-    Patient *findPatient(int id)
+    unordered_map<int, map<int, int>> schedule; // doctorId -> start -> appointment id
+    multimap<int, int> timeline;                // start -> appointment id
+
+    void scheduleAppointment(const Appointment &a)
+    {
+        if (a.start < 0)
+            return;
+        schedule[a.doctorId].emplace(a.start, a.id);
+        timeline.emplace(a.start, a.id);
+    }
+
+    string walPath() const { return hospitalId + "_wal.log"; }
+
+    void logRecord(const string &line)
+    {
+        if (walPending == 0)
+            walFirstPending = chrono::steady_clock::now();
+        walBuffer += line + "\n";
+        walPending++;
+        auto waited = chrono::duration_cast<chrono::milliseconds>(
+            chrono::steady_clock::now() - walFirstPending);
+        if (walPending >= WAL_GROUP_COMMIT_RECORDS || waited.count() >= WAL_GROUP_COMMIT_MS)
+            commitLog();
+    }
+
+    // Rotates the log and rewrites the tables from a snapshot on another thread;
+    // the rotated log is only removed once the tables are safely replaced.
+    void startCompaction()
     {
-        for (auto *p = patients; p; p = p->next)
-            if (p->id == id)
-                return p;
-        return nullptr;
+        if (compactor.joinable())
+            compactor.join();
+        string live = walPath(), old = live + ".old";
+        remove(old.c_str());
+        if (rename(live.c_str(), old.c_str()) != 0)
+            return;
+        walRecords = 0;
+        string hid = hospitalId;
+        compactor = thread([hid, old, ps = patients.records, ds = doctors.records,
+                            as = appointments.records]()
+                           {
+            writeTables(hid, ps, ds, as);
+            remove(old.c_str()); });
+    }
+
+    // Re-applies logged registrations the CSVs don't have yet. A last line
+    // without its newline was cut off mid-append and was never committed; it
+    // is cut from the file too, or the next append would be glued onto it.
+    bool replayLog(const string &fn)
+    {
+        string text;
+        {
+            ifstream f(fn);
+            if (!f)
+                return false;
+            stringstream buf;
+            buf << f.rdbuf();
+            text = buf.str();
+        }
+        size_t end = text.rfind('\n') == string::npos ? 0 : text.rfind('\n') + 1;
+        if (end < text.size())
+        {
+            text.erase(end);
+            saveCsv(fn, text);
+        }
+        istringstream in(text);
+        string line;
+        while (getline(in, line))
+        {
+            vector<string> cols = splitRow(line);
+            int id;
+            if (cols.size() < 2 || !parseInt(cols[1], id))
+                continue;
+            string tag = cols[0];
+            cols.erase(cols.begin());
+            if (tag == "P" && !patients.find(id))
+                addRow(patients, cols);
+            else if (tag == "D" && !doctors.find(id))
+                addRow(doctors, cols);
+            else if (tag == "A" && !appointments.find(id))
+                addRow(appointments, cols);
+        }
+        return true;
     }
-    Doctor *findDoctor(int id)
+    static size_t countLines(const string &fn)
     {
-        for (auto *d = doctors; d; d = d->next)
-            if (d->id == id)
-                return d;
-        return nullptr;
+        ifstream f(fn);
+        return count(istreambuf_iterator<char>(f), istreambuf_iterator<char>(), '\n');
     }
 
+    Patient *findPatient(int id) { return patients.find(id); }
+    Doctor *findDoctor(int id) { return doctors.find(id); }
+
     template <typename T>
-    void loadList(const string &fn, T *&head)
+    void loadList(const string &fn, RecordStore<T> &store)
     {
         ifstream f(fn);
         if (!f)
             return;
+        stringstream buf;
+        buf << f.rdbuf();
+        parseCsv(buf.str(), store);
+    }
+    // Size the store up front from the line count: one bulk allocation
+    template <typename T>
+    static void parseCsv(const string &text, RecordStore<T> &store)
+    {
+        store.reserve(store.size() + count(text.begin(), text.end(), '\n'));
+        istringstream in(text);
         string line;
-        getline(f, line);
-        while (getline(f, line))
+        getline(in, line);
+        while (getline(in, line))
+            addRow(store, splitRow(line));
+    }
+    // Splits a segment into its three CSV sections
+    void loadSegment(const string &text)
+    {
+        size_t d = text.find("#doctors\n"), a = text.find("#appointments\n");
+        if (d == string::npos || a == string::npos)
+            return;
+        size_t p = strlen("#patients\n");
+        parseCsv(text.substr(p, d - p), patients);
+        d += strlen("#doctors\n");
+        parseCsv(text.substr(d, a - d), doctors);
+        parseCsv(text.substr(a + strlen("#appointments\n")), appointments);
+    }
+
+    static vector<string> splitRow(const string &line)
+    {
+        stringstream ss(line);
+        vector<string> cols;
+        string tok;
+        while (getline(ss, tok, ','))
+            cols.push_back(tok);
+        return cols;
+    }
+    // Rows with too few columns or non-numeric ids are skipped
+    template <typename T>
+    static bool addRow(RecordStore<T> &store, const vector<string> &cols)
+    {
+        int id;
+        if (cols.empty() || !parseInt(cols[0], id))
+            return false;
+        if constexpr (is_same<T, Patient>::value)
         {
-            stringstream ss(line);
-            vector<string> cols;
-            string tok;
-            while (getline(ss, tok, ','))
-                cols.push_back(tok);
-            if constexpr (is_same<T, Patient>::value)
-            {
-                head = new Patient{stoi(cols[0]), cols[1], cols[2], cols[3], head};
-            }
-            else if constexpr (is_same<T, Doctor>::value)
-            {
-                head = new Doctor{stoi(cols[0]), cols[1], cols[2], head};
-            }
-            else
-            {
-                head = new Appointment{stoi(cols[0]), stoi(cols[1]), stoi(cols[2]), cols[3], head};
-            }
+            if (cols.size() < 4)
+                return false;
+            store.add({id, cols[1], cols[2], cols[3]});
         }
+        else if constexpr (is_same<T, Doctor>::value)
+        {
+            if (cols.size() < 3)
+                return false;
+            store.add({id, cols[1], cols[2]});
+        }
+        else
+        {
+            int pid, did;
+            if (cols.size() < 4 || !parseInt(cols[1], pid) || !parseInt(cols[2], did))
+                return false;
+            store.add({id, pid, did, cols[3], parseDateTime(cols[3])});
+        }
+        return true;
     }
 
-    void savePatients(const string &fn)
+    // Each file is written to a temp name and renamed over the old one
+    static void replaceFile(const string &tmp, const string &fn)
     {
-        ofstream f(fn);
+        if (rename(tmp.c_str(), fn.c_str()) != 0) // Windows won't rename over a file
+        {
+            remove(fn.c_str());
+            rename(tmp.c_str(), fn.c_str());
+        }
+    }
+    static void saveCsv(const string &fn, const string &text)
+    {
+        {
+            ofstream f(fn + ".tmp");
+            f << text;
+        }
+        replaceFile(fn + ".tmp", fn);
+    }
+    static void writeTables(const string &hid, const vector<Patient> &ps,
+                            const vector<Doctor> &ds, const vector<Appointment> &as)
+    {
+        if (segmentStore)
+        {
+            segmentStore->write(hid, segmentOf(ps, ds, as));
+            return;
+        }
+        saveCsv(hid + "_patients.csv", patientsCsv(ps));
+        saveCsv(hid + "_doctors.csv", doctorsCsv(ds));
+        saveCsv(hid + "_appointments.csv", appointmentsCsv(as));
+    }
+    static string segmentOf(const vector<Patient> &ps, const vector<Doctor> &ds,
+                            const vector<Appointment> &as)
+    {
+        return "#patients\n" + patientsCsv(ps) + "#doctors\n" + doctorsCsv(ds) +
+               "#appointments\n" + appointmentsCsv(as);
+    }
+    static string patientsCsv(const vector<Patient> &rows)
+    {
+        ostringstream f;
         f << "id,name,dob,gender\n";
-        for (auto *p = patients; p; p = p->next)
-            f << p->id << ',' << p->name << ',' << p->dob << ',' << p->gender << "\n";
+        for (auto &p : rows)
+            f << p.id << ',' << p.name << ',' << p.dob << ',' << p.gender << "\n";
+        return f.str();
     }
-    void saveDoctors(const string &fn)
+    static string doctorsCsv(const vector<Doctor> &rows)
     {
-        ofstream f(fn);
+        ostringstream f;
         f << "id,name,specialization\n";
-        for (auto *d = doctors; d; d = d->next)
-            f << d->id << ',' << d->name << ',' << d->specialization << "\n";
+        for (auto &d : rows)
+            f << d.id << ',' << d.name << ',' << d.specialization << "\n";
+        return f.str();
     }
-    void saveAppointments(const string &fn)
+    static string appointmentsCsv(const vector<Appointment> &rows)
     {
-        ofstream f(fn);
+        ostringstream f;
         f << "id,patientId,doctorId,date\n";
-        for (auto *a = appointments; a; a = a->next)
-            f << a->id << ',' << a->patientId << ',' << a->doctorId << ',' << a->date << "\n";
+        for (auto &a : rows)
+            f << a.id << ',' << a.patientId << ',' << a.doctorId << ',' << a.date << "\n";
+        return f.str();
     }
 
     void normalizeCounters()
     {
-        for (auto *p = patients; p; p = p->next)
-            nextPatientId = max(nextPatientId, p->id + 1);
-        for (auto *d = doctors; d; d = d->next)
-            nextDoctorId = max(nextDoctorId, d->id + 1);
-        for (auto *a = appointments; a; a = a->next)
-            nextAppointmentId = max(nextAppointmentId, a->id + 1);
+        for (auto &p : patients)
+            nextPatientId = max(nextPatientId, p.id + 1);
+        for (auto &d : doctors)
+            nextDoctorId = max(nextDoctorId, d.id + 1);
+        for (auto &a : appointments)
+            nextAppointmentId = max(nextAppointmentId, a.id + 1);
+    }
+};
+
+// ======== Network-wide Patient Index ========
+// Secondary index over every hospital's patients, kept in patient_index.csv
+// (one appended line per registration) so lookups never open hospital CSVs.
+// The maps are built from the file on the first lookup of a run, which is a
+// linear pass over every row.
+
+struct PatientRef
+{
+    string hospitalId;
+    int patientId;
+    string name, dob;
+};
+
+class PatientIndex
+{
+public:
+    const string file = "patient_index.csv";
+    bool loaded = false;
+
+    bool exists() const { return ifstream(file).good(); }
+
+    // One read of the whole file, split in place; a later row for the same
+    // hospital and id replaces an earlier one
+    void ensureLoaded()
+    {
+        if (loaded)
+            return;
+        loaded = true;
+        ifstream f(file, ios::binary);
+        string text((istreambuf_iterator<char>(f)), istreambuf_iterator<char>());
+        size_t pos = text.find('\n'); // header
+        while (pos != string::npos && pos + 1 < text.size())
+        {
+            size_t start = pos + 1, end = text.find('\n', start);
+            pos = end;
+            if (end == string::npos)
+                break; // torn last row
+            size_t c1 = text.find(',', start), c2 = c1 < end ? text.find(',', c1 + 1) : end,
+                   c3 = c2 < end ? text.find(',', c2 + 1) : end;
+            int id;
+            if (c3 >= end || !parseInt(text.substr(c1 + 1, c2 - c1 - 1), id))
+                continue;
+            size_t c4 = min(text.find(',', c3 + 1), end);
+            insert({text.substr(start, c1 - start), id, text.substr(c2 + 1, c3 - c2 - 1),
+                    text.substr(c3 + 1, c4 - c3 - 1)});
+        }
+    }
+
+    // Appends without loading the file: duplicates are settled at load time
+    void add(const PatientRef &ref)
+    {
+        if (loaded)
+            insert(ref);
+        bool torn = !tailChecked && !endsWithNewline();
+        tailChecked = true;
+        ofstream f(file, ios::app);
+        if (f.tellp() == 0)
+            f << "hospital,id,name,dob\n";
+        else if (torn)
+            f << "\n"; // close a row cut off mid-append so ours isn't glued onto it
+        f << ref.hospitalId << ',' << ref.patientId << ',' << ref.name << ',' << ref.dob << "\n";
+    }
+
+    // Rare: drops a deleted hospital's entries and rewrites the file
+    void removeHospital(const string &hid)
+    {
+        ensureLoaded();
+        vector<PatientRef> kept;
+        for (auto &r : refs)
+            if (r.hospitalId != hid)
+                kept.push_back(r);
+        rewrite(kept);
+    }
+    void rewrite(const vector<PatientRef> &kept)
+    {
+        loaded = true;
+        clear();
+        ofstream f(file);
+        f << "hospital,id,name,dob\n";
+        for (auto &r : kept)
+        {
+            insert(r);
+            f << r.hospitalId << ',' << r.patientId << ',' << r.name << ',' << r.dob << "\n";
+        }
+    }
+
+    vector<PatientRef> findByName(const string &nm) { return collect(byName, toLowerStr(nm)); }
+    vector<PatientRef> findByDob(const string &dob) { return collect(byDob, dob); }
+    const PatientRef *find(const string &hid, int id)
+    {
+        ensureLoaded();
+        auto it = byKey.find(key(hid, id));
+        return it == byKey.end() ? nullptr : &refs[it->second];
+    }
+
+private:
+    vector<PatientRef> refs;
+    unordered_multimap<string, size_t> byName, byDob;
+    bool tailChecked = false; // rows this run appends always end in '\n'
+
+    bool endsWithNewline() const
+    {
+        ifstream f(file, ios::binary | ios::ate);
+        if (!f || f.tellg() <= 0)
+            return true;
+        f.seekg(-1, ios::end);
+        return f.get() == '\n';
+    }
+    unordered_map<string, size_t> byKey; // "H3#17" -> position in refs
+
+    static string key(const string &hid, int id) { return hid + '#' + to_string(id); }
+
+    void insert(const PatientRef &ref)
+    {
+        auto old = byKey.find(key(ref.hospitalId, ref.patientId));
+        if (old != byKey.end())
+        {
+            // Same patient again: unlink the old name/dob entries, reuse the slot
+            size_t pos = old->second;
+            unlink(byName, toLowerStr(refs[pos].name), pos);
+            unlink(byDob, refs[pos].dob, pos);
+            refs[pos] = ref;
+            byName.emplace(toLowerStr(ref.name), pos);
+            byDob.emplace(ref.dob, pos);
+            return;
+        }
+        size_t pos = refs.size();
+        refs.push_back(ref);
+        byName.emplace(toLowerStr(ref.name), pos);
+        byDob.emplace(ref.dob, pos);
+        byKey[key(ref.hospitalId, ref.patientId)] = pos;
+    }
+    static void unlink(unordered_multimap<string, size_t> &m, const string &k, size_t pos)
+    {
+        auto range = m.equal_range(k);
+        for (auto it = range.first; it != range.second; ++it)
+            if (it->second == pos)
+            {
+                m.erase(it);
+                return;
+            }
+    }
+    void clear()
+    {
+        refs.clear();
+        byName.clear();
+        byDob.clear();
+        byKey.clear();
+    }
+    vector<PatientRef> collect(unordered_multimap<string, size_t> &m, const string &k)
+    {
+        ensureLoaded();
+        vector<PatientRef> out;
+        auto range = m.equal_range(k);
+        for (auto it = range.first; it != range.second; ++it)
+            out.push_back(refs[it->second]);
+        return out;
+    }
+};
+
+// ======== Specialization Index ========
+// One bitmap per specialization with a bit per hospital slot, persisted as
+// (specialization, hospital) rows in specialization_index.csv.
+class SpecialtyIndex
+{
+public:
+    const string file = "specialization_index.csv";
+
+    bool exists() const { return ifstream(file).good(); }
+
+    // Loads persisted rows; slotOf maps hospital IDs to bitmap positions
+    void load(const unordered_map<string, int> &slotOf)
+    {
+        ifstream f(file);
+        string line;
+        getline(f, line);
+        while (getline(f, line))
+        {
+            stringstream ss(line);
+            string spec, hid;
+            getline(ss, spec, ',');
+            getline(ss, hid, ',');
+            auto it = slotOf.find(hid);
+            if (it != slotOf.end())
+                set(spec, it->second);
+        }
+    }
+
+    bool has(const string &spec, int slot) const
+    {
+        auto it = bitmaps.find(toLowerStr(spec));
+        return it != bitmaps.end() && slot < (int)it->second.size() && it->second[slot];
+    }
+
+    // Records that hospital `hid` has a doctor with `spec`; appends only new pairs
+    void add(const string &spec, const string &hid, int slot)
+    {
+        if (has(spec, slot))
+            return;
+        set(spec, slot);
+        if (!exists())
+            ofstream(file) << "specialization,hospital\n";
+        ofstream(file, ios::app) << toLowerStr(spec) << ',' << hid << "\n";
+    }
+
+    // Clears a deleted hospital's bits and rewrites the file
+    void removeSlot(int slot, const vector<string> &idOfSlot)
+    {
+        for (auto &kv : bitmaps)
+            if (slot < (int)kv.second.size())
+                kv.second[slot] = false;
+        ofstream f(file);
+        f << "specialization,hospital\n";
+        for (auto &kv : bitmaps)
+            for (int s = 0; s < (int)kv.second.size(); ++s)
+                if (kv.second[s])
+                    f << kv.first << ',' << idOfSlot[s] << "\n";
+    }
+
+private:
+    unordered_map<string, vector<bool>> bitmaps; // lower-cased specialization -> slots
+
+    void set(const string &spec, int slot)
+    {
+        auto &bits = bitmaps[toLowerStr(spec)];
+        if ((int)bits.size() <= slot)
+            bits.resize(slot + 1);
+        bits[slot] = true;
     }
 };
 
@@ -224,29 +1340,131 @@ class Graph
 {
 
 private:
+    // --- Adjacency over hospital slots ---
+    // adj[u] lists u's roads; edges maps the slot pair to the distance and
+    // to where the edge sits in both lists, so connect/update/delete are O(1)
+    // and removing a hospital only visits its own neighbours.
+    struct Edge
+    {
+        int to, dist;
+    };
+    struct EdgeInfo
+    {
+        int dist, posLo, posHi; // index in adj[min slot] / adj[max slot]
+    };
+    vector<vector<Edge>> adj;
+    unordered_map<uint64_t, EdgeInfo> edges;
+
+    static uint64_t edgeKey(int a, int b)
+    {
+        if (a > b)
+            swap(a, b);
+        return (uint64_t)a << 32 | (uint32_t)b;
+    }
+    int &edgePos(int from, int to)
+    {
+        EdgeInfo &e = edges[edgeKey(from, to)];
+        return from < to ? e.posLo : e.posHi;
+    }
     bool areConnected(const string &a, const string &b)
     {
-        if (adj.find(a) == adj.end())
-            return false;
-        for (const auto &edge : adj[a])
+        return edges.count(edgeKey(slotOf[a], slotOf[b])) > 0;
+    }
+    void addEdge(const string &a, const string &b, int dist)
+    {
+        int u = slotOf[a], v = slotOf[b];
+        adj[u].push_back({v, dist});
+        adj[v].push_back({u, dist});
+        edges[edgeKey(u, v)] = {dist, 0, 0};
+        edgePos(u, v) = adj[u].size() - 1;
+        edgePos(v, u) = adj[v].size() - 1;
+    }
+    // Swap-removes v from adj[u], fixing the position of the edge moved into its place
+    void unlinkHalf(int u, int v)
+    {
+        int pos = edgePos(u, v);
+        Edge moved = adj[u].back();
+        adj[u][pos] = moved;
+        adj[u].pop_back();
+        if (moved.to != v)
+            edgePos(u, moved.to) = pos;
+    }
+    void removeEdge(int u, int v)
+    {
+        unlinkHalf(u, v);
+        unlinkHalf(v, u);
+        edges.erase(edgeKey(u, v));
+    }
+
+    // Loaded hospitals, most recently managed first
+    list<string> lru;
+    unordered_map<string, list<string>::iterator> lruPos;
+
+    Hospital *acquireHospital(const string &hid)
+    {
+        Hospital *h = nodes[hid];
+        h->ensureLoaded();
+        if (lruPos.count(hid))
+            lru.erase(lruPos[hid]);
+        lru.push_front(hid);
+        lruPos[hid] = lru.begin();
+        enforceBudget();
+        return h;
+    }
+    void releaseHospital(const string &hid)
+    {
+        if (!lruPos.count(hid))
+            return;
+        lru.erase(lruPos[hid]);
+        lruPos.erase(hid);
+    }
+    // Evict from the cold end until within budget, always keeping the newest
+    void enforceBudget()
+    {
+        size_t total = 0;
+        for (auto &id : lru)
+            total += nodes[id]->recordCount();
+        while (total > LOADED_RECORD_BUDGET && lru.size() > 1)
         {
-            if (edge.first == b)
-            {
-                return true;
-            }
+            Hospital *cold = nodes[lru.back()];
+            total -= cold->recordCount();
+            cold->unload();
+            lruPos.erase(lru.back());
+            lru.pop_back();
         }
-        return false;
     }
 
 public:
     unordered_map<string, Hospital *> nodes;
-    unordered_map<string, vector<pair<string, int>>> adj;
     int nextHospitalIndex = 1;
+    PatientIndex patientIndex;
+    SpecialtyIndex specialtyIndex;
+
+    // Dense integer slot per hospital, reused after deletes
+    unordered_map<string, int> slotOf;
+    vector<string> idOfSlot;
+    vector<int> freeSlots;
+
+    // A missing index file is rebuilt on first use, in one pass for both
+    bool patientIndexMissing = false, specialtyIndexMissing = false;
 
     Graph()
     {
+        if (SegmentFile::exists(DATA_FILE))
+            segmentStore = new SegmentFile(DATA_FILE);
         loadHospitals();
         loadConnections();
+        patientIndexMissing = !patientIndex.exists();
+        specialtyIndexMissing = !specialtyIndex.exists();
+        if (!specialtyIndexMissing)
+            specialtyIndex.load(slotOf);
+    }
+    ~Graph()
+    {
+        for (auto &kv : nodes)
+            delete kv.second;
+        delete segmentStore;
+        segmentStore = nullptr;
     }
 
     // --- Node operations ---
@@ -260,6 +1478,7 @@ public:
         getline(cin, loc);
         string id = genId();
         nodes[id] = new Hospital(id, nm, loc);
+        assignSlot(id);
         saveHospitals();
         saveConnections();
         cout << "Added: " << id << "\n";
@@ -274,17 +1493,21 @@ public:
             cout << "Not found.\n";
             return;
         }
+        rebuildMissingIndexes();
+        releaseHospital(id);
+        patientIndex.removeHospital(id);
+        specialtyIndex.removeSlot(slotOf[id], idOfSlot);
+        int u = slotOf[id];
+        while (!adj[u].empty())
+            removeEdge(u, adj[u].back().to);
+        releaseSlot(id);
+        // Drop the pending log and join any compaction first, so nothing
+        // writes the segment back after it is erased
+        nodes[id]->discard();
+        if (segmentStore)
+            segmentStore->erase(id);
         delete nodes[id];
         nodes.erase(id);
-        adj.erase(id);
-        for (auto &kv : adj)
-        {
-            auto &v = kv.second;
-            v.erase(remove_if(v.begin(), v.end(),
-                              [&](auto &p)
-                              { return p.first == id; }),
-                    v.end());
-        }
         saveHospitals();
         saveConnections();
         cout << "Deleted " << id << "\n";
@@ -322,7 +1545,7 @@ public:
         cout << "To ID:   ";
         string b;
         getline(cin, b);
-        if (!nodes.count(a) || !nodes.count(b))
+        if (!nodes.count(a) || !nodes.count(b) || a == b)
         {
             cout << "Invalid IDs.\n";
             return;
@@ -333,8 +1556,7 @@ public:
             return;
         }
         int dist = readInt("Distance (km): ", 0);
-        adj[a].push_back({b, dist});
-        adj[b].push_back({a, dist});
+        addEdge(a, b, dist);
         saveConnections();
         cout << "Connected " << a << " <-> " << b << "\n";
     }
@@ -345,21 +1567,16 @@ public:
             cout << "Invalid IDs.\n";
             return;
         }
-        auto &va = adj[a], &vb = adj[b];
-        int idxA = -1, idxB = -1;
-        for (int i = 0; i < va.size(); ++i)
-            if (va[i].first == b)
-                idxA = i;
-        for (int i = 0; i < vb.size(); ++i)
-            if (vb[i].first == a)
-                idxB = i;
-        if (idxA < 0 || idxB < 0)
+        int u = slotOf[a], v = slotOf[b];
+        auto it = edges.find(edgeKey(u, v));
+        if (it == edges.end())
         {
             cout << "No connection found.\n";
             return;
         }
         int nd = readInt("New distance (km): ", 0);
-        va[idxA].second = vb[idxB].second = nd;
+        it->second.dist = nd;
+        adj[u][edgePos(u, v)].dist = adj[v][edgePos(v, u)].dist = nd;
         saveConnections();
         cout << "Updated " << a << "<->" << b << " to " << nd << "km\n";
     }
@@ -370,15 +1587,8 @@ public:
             cout << "Invalid IDs.\n";
             return;
         }
-        auto &va = adj[a], &vb = adj[b];
-        va.erase(remove_if(va.begin(), va.end(),
-                           [&](auto &p)
-                           { return p.first == b; }),
-                 va.end());
-        vb.erase(remove_if(vb.begin(), vb.end(),
-                           [&](auto &p)
-                           { return p.first == a; }),
-                 vb.end());
+        if (areConnected(a, b))
+            removeEdge(slotOf[a], slotOf[b]);
         saveConnections();
         cout << "Removed connection " << a << " <-> " << b << "\n";
     }
@@ -393,15 +1603,122 @@ public:
     void displayNetwork()
     {
         cout << "-- Network --\n";
-        for (auto &kv : adj)
+        for (int u = 0; u < (int)adj.size(); ++u)
         {
-            cout << kv.first << " -> ";
-            for (auto &e : kv.second)
-                cout << e.first << "(" << e.second << "km) ";
+            if (adj[u].empty())
+                continue;
+            cout << idOfSlot[u] << " -> ";
+            for (auto &e : adj[u])
+                cout << idOfSlot[e.to] << "(" << e.dist << "km) ";
             cout << "\n";
         }
     }
 
+    // --- Storage: single data file <-> per-hospital CSVs ---
+    // Import copies every hospital (from its CSVs) into hospital_data.dat and
+    // switches to it; export writes the CSVs from whichever store is active.
+    void importDataFile()
+    {
+        if (segmentStore)
+        {
+            cout << "Already using " << DATA_FILE << ".\n";
+            return;
+        }
+        SegmentFile::create(DATA_FILE);
+        SegmentFile *target = new SegmentFile(DATA_FILE);
+        target->beginBatch();
+        for (auto &kv : nodes)
+        {
+            Hospital *h = kv.second;
+            bool wasLoaded = h->loaded;
+            h->ensureLoaded();
+            h->commitLog();
+            target->write(kv.first, h->segmentText());
+            if (!wasLoaded)
+                h->unload();
+        }
+        target->endBatch();
+        segmentStore = target;
+        cout << "Imported " << nodes.size() << " hospital(s) into " << DATA_FILE
+             << ". The per-hospital CSVs are no longer read and may be removed.\n";
+    }
+    void exportCsvFiles()
+    {
+        for (auto &kv : nodes)
+        {
+            Hospital *h = kv.second;
+            bool wasLoaded = h->loaded;
+            h->ensureLoaded();
+            h->exportCsv();
+            if (!wasLoaded)
+                h->unload();
+        }
+        cout << "Exported " << nodes.size() << " hospital(s) to CSV.\n";
+    }
+
+    // --- Network-wide patient search ---
+    void findPatient()
+    {
+        cout << "Search by: 1. Name  2. Date of Birth  3. Hospital + Patient ID\n";
+        int mode = readInt("Choose: ", 1, 3);
+        rebuildMissingIndexes();
+        vector<PatientRef> hits;
+        if (mode == 3)
+        {
+            cout << "Hospital ID: ";
+            string hid;
+            getline(cin, hid);
+            int id = readInt("Patient ID: ", 1);
+            if (const PatientRef *r = patientIndex.find(hid, id))
+                hits.push_back(*r);
+        }
+        else
+        {
+            cout << (mode == 1 ? "Name: " : "DOB: ");
+            string q;
+            getline(cin, q);
+            hits = mode == 1 ? patientIndex.findByName(q) : patientIndex.findByDob(q);
+        }
+        cout << "-- " << hits.size() << " match(es) --\n";
+        for (auto &r : hits)
+        {
+            string hname = nodes.count(r.hospitalId) ? nodes[r.hospitalId]->name : "?";
+            cout << r.hospitalId << " (" << hname << ") P" << r.patientId << ": "
+                 << r.name << " | " << r.dob << "\n";
+        }
+    }
+
+    // --- Referrals: Dijkstra that stops at the first k specialist hospitals ---
+    vector<pair<string, int>> nearestWithSpecialization(const string &from, const string &spec, int k)
+    {
+        rebuildMissingIndexes();
+        vector<pair<string, int>> found;
+        int src = slotOf[from];
+        vector<int> dist(adj.size(), INT_MAX);
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
+        dist[src] = 0;
+        pq.push({0, src});
+        while (!pq.empty() && (int)found.size() < k)
+        {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > dist[u])
+                continue;
+            if (u != src && specialtyIndex.has(spec, u))
+                found.push_back({idOfSlot[u], d});
+            for (auto &e : adj[u])
+            {
+                int nd = d + e.dist;
+                if (nd < dist[e.to])
+                {
+                    dist[e.to] = nd;
+                    pq.push({nd, e.to});
+                }
+            }
+        }
+        return found;
+    }
+
     // --- Per-hospital management ---
     void manageHospital()
     {
@@ -413,7 +1730,7 @@ public:
             cout << "Not found.\n";
             return;
         }
-        Hospital *h = nodes[hid];
+        Hospital *h = acquireHospital(hid);
         while (true)
         {
             cout << "\n-- Managing " << h->name << " (" << hid << ") --\n"
@@ -427,10 +1744,17 @@ public:
                  << "8. Add Connection\n"
                  << "9. Update Connection\n"
                  << "10.Delete Connection\n"
-                 << "11.Go Back\n";
-            int c = readInt("Choose: ", 1, 11);
-            if (c == 11)
+                 << "11.Doctor Availability\n"
+                 << "12.Appointments in Date Range\n"
+                 << "13.Refer to Specialist\n"
+                 << "14.Reports\n"
+                 << "15.Go Back\n";
+            int c = readInt("Choose: ", 1, 15);
+            if (c == 15)
+            {
+                enforceBudget();
                 break;
+            }
             switch (c)
             {
             case 1:
@@ -444,7 +1768,10 @@ public:
                 cout << "Gender: ";
                 string g;
                 getline(cin, g);
-                cout << "Added Patient " << h->registerPatient(n, d, g) << "\n";
+                int id = h->registerPatient(n, d, g);
+                if (!patientIndexMissing) // else the rebuild picks it up
+                    patientIndex.add({hid, id, n, d});
+                cout << "Added Patient " << id << "\n";
                 break;
             }
             case 2:
@@ -456,16 +1783,26 @@ public:
                 string s;
                 getline(cin, s);
                 cout << "Added Doctor " << h->registerDoctor(n, s) << "\n";
+                if (!specialtyIndexMissing)
+                    specialtyIndex.add(s, hid, slotOf[hid]);
                 break;
             }
             case 3:
             {
                 int pid = readInt("Patient ID: ", 1), did = readInt("Doctor ID: ", 1);
-                cout << "Date: ";
+                cout << "Date (YYYY-MM-DD HH:MM): ";
                 string dt;
                 getline(cin, dt);
                 int id = h->registerAppointment(pid, did, dt);
-                cout << (id < 0 ? "Invalid IDs" : "Added Appointment " + to_string(id)) << "\n";
+                if (id == -1)
+                    cout << "Invalid IDs\n";
+                else if (id == -2)
+                    cout << "Doctor already booked; next free slot is "
+                         << formatDateTime(h->nextFreeSlot(did, parseDateTime(dt))) << "\n";
+                else if (id == -3)
+                    cout << "Invalid date\n";
+                else
+                    cout << "Added Appointment " << id << "\n";
                 break;
             }
             case 4:
@@ -480,8 +1817,8 @@ public:
             case 7:
             {
                 cout << "-- Connections from " << hid << " --\n";
-                for (auto &e : adj[hid])
-                    cout << e.first << "(" << e.second << "km)\n";
+                for (auto &e : adj[slotOf[hid]])
+                    cout << idOfSlot[e.to] << "(" << e.dist << "km)\n";
                 break;
             }
             case 8:
@@ -489,7 +1826,7 @@ public:
                 cout << "Connect to ID: ";
                 string other;
                 getline(cin, other);
-                if (!nodes.count(other))
+                if (!nodes.count(other) || other == hid)
                 {
                     cout << "Invalid ID.\n";
                     break;
@@ -500,8 +1837,7 @@ public:
                     break;
                 }
                 int dist = readInt("Distance (km): ", 0);
-                adj[hid].push_back({other, dist});
-                adj[other].push_back({hid, dist});
+                addEdge(hid, other, dist);
                 saveConnections();
                 cout << "Connected.\n";
                 break;
@@ -522,11 +1858,118 @@ public:
                 deleteConnection(hid, other);
                 break;
             }
+            case 11:
+            {
+                int did = readInt("Doctor ID: ", 1);
+                cout << "Date (YYYY-MM-DD HH:MM): ";
+                string dt;
+                getline(cin, dt);
+                int t = parseDateTime(dt);
+                if (!h->hasDoctor(did))
+                    cout << "Invalid Doctor ID\n";
+                else if (t < 0)
+                    cout << "Invalid date\n";
+                else if (h->isDoctorFree(did, t))
+                    cout << "Doctor " << did << " is free at " << formatDateTime(t) << "\n";
+                else
+                    cout << "Doctor " << did << " is booked; next free slot is "
+                         << formatDateTime(h->nextFreeSlot(did, t)) << "\n";
+                break;
+            }
+            case 12:
+            {
+                cout << "From (YYYY-MM-DD [HH:MM]): ";
+                string a;
+                getline(cin, a);
+                cout << "To   (YYYY-MM-DD [HH:MM]): ";
+                string b;
+                getline(cin, b);
+                int from = parseDateTime(a), to = parseDateTime(b);
+                if (to >= 0 && b.find(':') == string::npos)
+                    to += 1440; // a date-only end covers that whole day
+                if (from < 0 || to < 0)
+                    cout << "Invalid date\n";
+                else
+                    h->displayAppointmentsBetween(from, to);
+                break;
+            }
+            case 13:
+            {
+                cout << "Specialization: ";
+                string spec;
+                getline(cin, spec);
+                int k = readInt("How many hospitals: ", 1);
+                auto hits = nearestWithSpecialization(hid, spec, k);
+                if (hits.empty())
+                    cout << "No reachable hospital has a " << spec << " doctor.\n";
+                for (auto &hit : hits)
+                    cout << hit.first << " | " << nodes[hit.first]->name << " | " << hit.second << "km\n";
+                break;
             }
+            case 14:
+                h->displayReports();
+                break;
+            }
+            // Don't leave typed-in registrations sitting in the group buffer
+            h->commitLog();
         }
     }
 
 private:
+    int assignSlot(const string &id)
+    {
+        int slot;
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            idOfSlot[slot] = id;
+        }
+        else
+        {
+            slot = idOfSlot.size();
+            idOfSlot.push_back(id);
+            adj.emplace_back();
+        }
+        slotOf[id] = slot;
+        return slot;
+    }
+    void releaseSlot(const string &id)
+    {
+        int slot = slotOf[id];
+        idOfSlot[slot].clear();
+        freeSlots.push_back(slot);
+        slotOf.erase(id);
+    }
+
+    // One-off: builds whichever of patient_index.csv and
+    // specialization_index.csv is missing, loading each hospital once
+    void rebuildMissingIndexes()
+    {
+        if (!patientIndexMissing && !specialtyIndexMissing)
+            return;
+        vector<PatientRef> all;
+        if (specialtyIndexMissing)
+            ofstream(specialtyIndex.file) << "specialization,hospital\n";
+        for (auto &kv : nodes)
+        {
+            Hospital *h = kv.second;
+            bool wasLoaded = h->loaded;
+            h->ensureLoaded();
+            if (patientIndexMissing)
+                for (auto &p : h->patients)
+                    all.push_back({kv.first, p.id, p.name, p.dob});
+            if (specialtyIndexMissing)
+                for (auto &d : h->doctors)
+                    specialtyIndex.add(d.specialization, kv.first, slotOf[kv.first]);
+            if (!wasLoaded)
+                h->unload();
+        }
+        if (patientIndexMissing)
+            patientIndex.rewrite(all); // one stream for the whole file
+        patientIndexMissing = specialtyIndexMissing = false;
+    }
+
     string genId()
     {
         return "H" + to_string(nextHospitalIndex++);
@@ -550,6 +1993,7 @@ private:
             getline(ss, loc, ',');
             maxIdx = max(maxIdx, stoi(id.substr(1)));
             nodes[id] = new Hospital(id, nm, loc);
+            assignSlot(id);
         }
         nextHospitalIndex = maxIdx + 1;
     }
@@ -577,27 +2021,19 @@ private:
             getline(ss, a, ',');
             getline(ss, b, ',');
             ss >> d;
-            if (nodes.count(a) && nodes.count(b))
-            {
-                adj[a].push_back({b, d});
-                adj[b].push_back({a, d});
-            }
+            if (nodes.count(a) && nodes.count(b) && a != b && !areConnected(a, b))
+                addEdge(a, b, d);
         }
     }
     void saveConnections()
     {
         ofstream f("connections.csv");
         f << "from,to,distance\n";
-        for (auto &kv : adj)
+        for (auto &kv : edges)
         {
-            const string &a = kv.first;
-            for (auto &e : kv.second)
-            {
-                const string &b = e.first;
-                int d = e.second;
-                if (a < b)
-                    f << a << ',' << b << ',' << d << "\n";
-            }
+            const string &a = idOfSlot[kv.first >> 32];
+            const string &b = idOfSlot[kv.first & 0xffffffffu];
+            f << a << ',' << b << ',' << kv.second.dist << "\n";
         }
     }
 };
@@ -616,9 +2052,12 @@ int main()
              << "5. List Hospitals\n"
              << "6. View Network\n"
              << "7. Manage Hospital\n"
-             << "8. Exit\n";
-        int choice = readInt("Choose: ", 1, 8);
-        if (choice == 8)
+             << "8. Find Patient\n"
+             << "9. Import CSVs into Data File\n"
+             << "10.Export Data File to CSVs\n"
+             << "11.Exit\n";
+        int choice = readInt("Choose: ", 1, 11);
+        if (choice == 11)
             break;
         switch (choice)
         {
@@ -643,6 +2082,15 @@ int main()
         case 7:
             graph.manageHospital();
             break;
+        case 8:
+            graph.findPatient();
+            break;
+        case 9:
+            graph.importDataFile();
+            break;
+        case 10:
+            graph.exportCsvFiles();
+            break;
         }
     }
     cout << "Goodbye!\n";
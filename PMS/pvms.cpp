@@ -9,6 +9,22 @@
 #include <algorithm>
 #include <climits>
 #include <ctime>
+#include <memory>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <queue>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <bitset>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <set>
+#include <deque>
+#include <cerrno>
+#include <cstdlib>
 
 using namespace std;
 
@@ -60,13 +76,776 @@ struct ParkingSpot
     ParkingSpot *next;
 };
 
+// Advance booking of one spot for [from, to), in parseTimestamp() seconds
+struct Reservation
+{
+    int id;
+    string plate;
+    int spotId;
+    long long from, to;
+};
+
 struct ParkingSession
 {
     int id;
     string vehicleId; // License plate
     int spotId;
     string entryTime, exitTime;
-    ParkingSession *next;
+    long long entryEpoch = -1, exitEpoch = -1; // parseTimestamp() of the above
+};
+
+// ======== Node Pool: block arena for linked records ========
+// Nodes are carved out of large blocks; released nodes are recycled and
+// every block is freed at once when the pool (i.e. the lot) goes away.
+template <typename T>
+class NodePool
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 1024;
+
+    T *create(const T &value)
+    {
+        T *slot;
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            if (used == capacity)
+                reserve(BLOCK_SIZE);
+            slot = &blocks.back()[used++];
+        }
+        *slot = value;
+        return slot;
+    }
+    void release(T *node)
+    {
+        *node = T{}; // drop the node's strings now, keep the slot
+        freeSlots.push_back(node);
+    }
+    // Makes sure the next n creates come from a single block
+    void reserve(size_t n)
+    {
+        if (capacity - used >= n)
+            return;
+        size_t size = max(n, BLOCK_SIZE);
+        blocks.emplace_back(new T[size]());
+        used = 0;
+        capacity = size;
+    }
+
+private:
+    vector<unique_ptr<T[]>> blocks;
+    vector<T *> freeSlots;
+    size_t used = 0, capacity = 0;
+};
+
+// ======== Free Spot List ========
+// Free spot IDs of one type with O(1) push, pop and remove-by-id
+struct FreeList
+{
+    vector<int> ids;
+    unordered_map<int, size_t> pos; // spot id -> index in ids
+
+    bool empty() const { return ids.empty(); }
+    size_t size() const { return ids.size(); }
+    void push(int id)
+    {
+        if (pos.count(id))
+            return;
+        pos[id] = ids.size();
+        ids.push_back(id);
+    }
+    void erase(int id)
+    {
+        auto it = pos.find(id);
+        if (it == pos.end())
+            return;
+        size_t i = it->second;
+        ids[i] = ids.back();
+        pos[ids[i]] = i;
+        ids.pop_back();
+        pos.erase(id);
+    }
+};
+
+// Whole-string integer parse for stored rows; false on empty, junk or overflow
+bool parseInt(const string &s, int &out)
+{
+    if (s.empty())
+        return false;
+    char *end;
+    errno = 0;
+    long v = strtol(s.c_str(), &end, 10);
+    if (*end || errno || v < INT_MIN || v > INT_MAX)
+        return false;
+    out = (int)v;
+    return true;
+}
+
+string toLowerStr(const string &s)
+{
+    string out = s;
+    transform(out.begin(), out.end(), out.begin(), ::tolower);
+    return out;
+}
+
+// Plates compare on upper-cased letters and digits only: "rad-220 c" == "RAD220C"
+string normalizePlate(const string &plate)
+{
+    string out;
+    out.reserve(plate.size());
+    for (unsigned char c : plate)
+        if (isalnum(c))
+            out += toupper(c);
+    return out;
+}
+
+// ======== Fuzzy Plate Matching ========
+// Folds characters plate cameras confuse (O/Q->0, I->1, Z->2, S->5, G->6,
+// B->8) so those misreads cost nothing; input is already normalized
+string ocrFold(const string &plate)
+{
+    string out = plate;
+    for (char &c : out)
+        switch (c)
+        {
+        case 'O':
+        case 'Q':
+            c = '0';
+            break;
+        case 'I':
+            c = '1';
+            break;
+        case 'Z':
+            c = '2';
+            break;
+        case 'S':
+            c = '5';
+            break;
+        case 'G':
+            c = '6';
+            break;
+        case 'B':
+            c = '8';
+            break;
+        }
+    return out;
+}
+
+// Per-character position masks of a pattern (up to 64 ASCII characters)
+// for editDistance(); built once per query
+struct PatternMasks
+{
+    uint64_t eq[128] = {};
+    int length = 0;
+
+    explicit PatternMasks(const string &p) : length(min<size_t>(p.size(), 64))
+    {
+        for (int i = 0; i < length; ++i)
+            eq[p[i] & 127] |= 1ULL << i;
+    }
+};
+
+// Edit distance from the pattern to text, one machine word per text
+// character (Myers' bit-parallel algorithm in Hyyrö's global form)
+int editDistance(const PatternMasks &p, const char *text, int n)
+{
+    if (p.length == 0)
+        return n;
+    uint64_t pv = ~0ULL, mv = 0, high = 1ULL << (p.length - 1);
+    int score = p.length;
+    for (int i = 0; i < n; ++i)
+    {
+        uint64_t eq = p.eq[text[i] & 127];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & high)
+            score++;
+        else if (mh & high)
+            score--;
+        ph = ph << 1 | 1; // the top row grows by one per text character
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    return score;
+}
+
+// Registered plates network-wide, searchable within two edits of their
+// folded form. Two edits touch at most two of a plate's four pieces, so any
+// plate in reach shares two whole pieces with the query, each shifted by
+// at most the edits before it. Every pair of pieces is indexed under a
+// fingerprint of (length, pair, content); a query looks each pair up at
+// every feasible shift. Each posting carries its plate's character set; an
+// edit drops at most one character from it and adds at most one, so most
+// false candidates are discarded while scanning, and the rest are checked
+// with the bit-parallel edit distance. Postings
+// live in a bucketed table plus a map of recent inserts that is folded
+// into the table once it reaches an eighth of its size. Adds and forgets
+// only queue into sharded inboxes, so gates never wait on the index or on a
+// rebuild; the next query applies the queue (the first one builds the index
+// in one pass). Deleted vehicles are not purged from the index: callers
+// verify each candidate against its lot and report stale ones through forget().
+class PlateMatcher
+{
+public:
+    static constexpr int MAX_EDITS = 2;
+    struct Candidate
+    {
+        string plate, lotId;
+        int distance;
+    };
+
+    void add(const string &plate, const string &lotId) { enqueue(plate, lotId, true); }
+    void forget(const string &plate, const string &lotId) { enqueue(plate, lotId, false); }
+
+    // Closest plates first, at most maxDistance (<= MAX_EDITS) edits away after folding
+    vector<Candidate> match(const string &plate, int maxDistance = MAX_EDITS)
+    {
+        maxDistance = min(maxDistance, MAX_EDITS);
+        string key = ocrFold(normalizePlate(plate));
+        vector<Candidate> out;
+        int len = key.size();
+        if (!len || len >= MAX_KEY)
+            return out;
+
+        applyQueued();
+        shared_lock<shared_mutex> lk(m);
+        uint32_t chars = charSet(key);
+        PatternMasks pattern(key);
+        vector<uint32_t> ids;
+        for (int klen = max(1, len - maxDistance); klen <= len + maxDistance && klen < MAX_KEY; ++klen)
+        {
+            if (!lengths[klen])
+                continue;
+            int b[PIECES + 1];
+            pieceBounds(klen, b);
+            int tail = len - klen; // net insertions over the whole plate
+            for (int i = 0; i < PIECES; ++i)
+                for (int j = i + 1; j < PIECES; ++j)
+                    for (int di = -maxDistance; di <= maxDistance; ++di)
+                        for (int dj = -maxDistance; dj <= maxDistance; ++dj)
+                        {
+                            // Nothing precedes the first piece or follows the last
+                            if ((i == 0 && di != 0) || (j == PIECES - 1 && dj != tail))
+                                continue;
+                            if (abs(di) + abs(dj - di) + abs(tail - dj) > maxDistance)
+                                continue;
+                            int si = b[i] + di, sj = b[j] + dj;
+                            int ni = b[i + 1] - b[i], nj = b[j + 1] - b[j];
+                            if (si < 0 || sj < 0 || si + ni > len || sj + nj > len)
+                                continue;
+                            lookup(fingerprint(klen, i, j, key.data() + si, ni, key.data() + sj, nj),
+                                   chars, maxDistance, ids);
+                        }
+        }
+        // A plate can be reached through several pairs; verify first, then
+        // drop repeats among the (few) hits
+        vector<pair<uint32_t, int>> hits;
+        vector<uint64_t> texts(ids.size());
+        for (size_t k = 0; k < ids.size(); ++k)
+            texts[k] = packed[ids[k]]; // gathered up front so the loads overlap
+        for (size_t k = 0; k < ids.size(); ++k)
+        {
+            char buf[MAX_KEY];
+            int n = unpack(texts[k], buf), d;
+            if (n)
+                d = editDistance(pattern, buf, n);
+            else
+            {
+                const string &text = longKeys.at(ids[k]);
+                d = editDistance(pattern, text.data(), text.size());
+            }
+            if (d <= maxDistance)
+                hits.push_back({ids[k], d});
+        }
+        sort(hits.begin(), hits.end());
+        hits.erase(unique(hits.begin(), hits.end()), hits.end());
+        for (auto &h : hits)
+            for (auto &o : owners[h.first])
+                out.push_back({o.first, o.second, h.second});
+        sort(out.begin(), out.end(), [](const Candidate &a, const Candidate &b)
+             { return a.distance != b.distance ? a.distance < b.distance : a.plate < b.plate; });
+        return out;
+    }
+
+private:
+    static constexpr int PIECES = MAX_EDITS + 2; // so two pieces always survive
+    static constexpr int MAX_KEY = 32;
+
+    // Queued adds/forgets; a plate always lands in the same inbox, so its
+    // operations are applied in the order they were made
+    static const size_t INBOXES = 64;
+    struct QueuedOp
+    {
+        string plate, lotId;
+        bool add;
+    };
+    struct Inbox
+    {
+        mutex m;
+        vector<QueuedOp> ops;
+    };
+    Inbox inboxes[INBOXES];
+    atomic<size_t> queued{0};
+
+    shared_mutex m; // the index proper; only queries take it
+    bool built = false;
+    // Folded plates by id, six bits a character; longer ones live in longKeys
+    vector<uint64_t> packed;
+    unordered_map<uint32_t, string> longKeys;
+    vector<vector<pair<string, string>>> owners; // id -> (plate, lot)
+    unordered_map<string, uint32_t> keyIds;
+    size_t lengths[MAX_KEY] = {}; // keys per length, to skip absent lengths
+
+    struct Posting
+    {
+        uint32_t fp, id, chars;
+    };
+    vector<Posting> postings;      // grouped by the fingerprint's low bits
+    vector<uint32_t> bucketStart; // bucket b spans [bucketStart[b], bucketStart[b + 1])
+    unordered_map<uint32_t, vector<Posting>> recent;
+    size_t recentCount = 0;
+
+    static uint32_t charSet(const string &key)
+    {
+        uint32_t set = 0;
+        for (char c : key)
+            set |= 1u << ((isdigit((unsigned char)c) ? c - '0' : 10 + c - 'A') % 32);
+        return set;
+    }
+
+    void enqueue(const string &plate, const string &lotId, bool add)
+    {
+        Inbox &q = inboxes[hash<string>()(plate) % INBOXES];
+        lock_guard<mutex> lk(q.m);
+        q.ops.push_back({plate, lotId, add});
+        queued.fetch_add(1, memory_order_release);
+    }
+
+    // Applies queued operations and folds recent postings into the table when
+    // due; holding m while draining keeps concurrent queries from reordering
+    void applyQueued()
+    {
+        if (built && queued.load(memory_order_acquire) == 0)
+            return;
+        unique_lock<shared_mutex> lk(m);
+        for (auto &q : inboxes)
+        {
+            vector<QueuedOp> ops;
+            {
+                lock_guard<mutex> qlk(q.m);
+                ops.swap(q.ops);
+            }
+            queued.fetch_sub(ops.size(), memory_order_relaxed);
+            for (auto &o : ops)
+                if (o.add)
+                    insert(o.plate, o.lotId);
+                else
+                    erase(o.plate, o.lotId);
+        }
+        if (!built || recentCount > max<size_t>(1024, postings.size() / 8))
+            rebuild();
+        built = true;
+    }
+
+    // Caller holds m exclusively, as for erase()
+    void insert(const string &plate, const string &lotId)
+    {
+        string key = ocrFold(normalizePlate(plate));
+        if (key.empty() || (int)key.size() >= MAX_KEY)
+            return;
+        auto it = keyIds.find(key);
+        uint32_t id;
+        if (it == keyIds.end())
+        {
+            id = packed.size();
+            keyIds[key] = id;
+            packed.push_back(pack(key));
+            if (!packed.back())
+                longKeys[id] = key;
+            owners.emplace_back();
+            lengths[key.size()]++;
+            indexKey(key, id);
+        }
+        else
+            id = it->second;
+        for (auto &o : owners[id])
+            if (o.first == plate && o.second == lotId)
+                return;
+        owners[id].push_back({plate, lotId});
+    }
+    void erase(const string &plate, const string &lotId)
+    {
+        auto it = keyIds.find(ocrFold(normalizePlate(plate)));
+        if (it == keyIds.end())
+            return;
+        auto &v = owners[it->second];
+        v.erase(remove(v.begin(), v.end(), make_pair(plate, lotId)), v.end());
+    }
+
+    static constexpr int PACKED_CHARS = 10;
+    static const char *packAlphabet() { return "?0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"; }
+
+    // 0 when the key does not fit
+    static uint64_t pack(const string &key)
+    {
+        if (key.size() > PACKED_CHARS)
+            return 0;
+        uint64_t v = 0;
+        for (size_t i = key.size(); i-- > 0;)
+            v = v << 6 | (isdigit((unsigned char)key[i]) ? key[i] - '0' + 1 : key[i] - 'A' + 11);
+        return v;
+    }
+    static int unpack(uint64_t v, char *out)
+    {
+        int n = 0;
+        for (; v; v >>= 6)
+            out[n++] = packAlphabet()[v & 63];
+        return n;
+    }
+
+    static void pieceBounds(int len, int b[PIECES + 1])
+    {
+        for (int k = 0; k <= PIECES; ++k)
+            b[k] = k * len / PIECES;
+    }
+
+    static uint32_t fingerprint(int len, int i, int j, const char *a, int na, const char *c, int nc)
+    {
+        uint64_t h = 1469598103934665603ULL; // FNV-1a
+        auto mix = [&](unsigned char x)
+        {
+            h ^= x;
+            h *= 1099511628211ULL;
+        };
+        mix(len);
+        mix(i * PIECES + j);
+        for (int k = 0; k < na; ++k)
+            mix(a[k]);
+        mix(0);
+        for (int k = 0; k < nc; ++k)
+            mix(c[k]);
+        return h ^ (h >> 32);
+    }
+
+    void indexKey(const string &key, uint32_t id)
+    {
+        int b[PIECES + 1];
+        pieceBounds(key.size(), b);
+        uint32_t chars = charSet(key);
+        for (int i = 0; i < PIECES; ++i)
+            for (int j = i + 1; j < PIECES; ++j)
+            {
+                uint32_t fp = fingerprint(key.size(), i, j, key.data() + b[i], b[i + 1] - b[i],
+                                          key.data() + b[j], b[j + 1] - b[j]);
+                if (!built)
+                    postings.push_back({fp, id, chars}); // bucketed by applyQueued()
+                else
+                {
+                    recent[fp].push_back({fp, id, chars});
+                    recentCount++;
+                }
+            }
+    }
+
+    // Counting sort of every posting into power-of-two buckets, about two per bucket
+    void rebuild()
+    {
+        for (auto &kv : recent)
+            postings.insert(postings.end(), kv.second.begin(), kv.second.end());
+        recent.clear();
+        recentCount = 0;
+        size_t buckets = 1;
+        while (buckets * 2 < postings.size())
+            buckets *= 2;
+        vector<uint32_t> start(buckets + 1, 0);
+        for (auto &p : postings)
+            start[(p.fp & (buckets - 1)) + 1]++;
+        for (size_t b = 0; b < buckets; ++b)
+            start[b + 1] += start[b];
+        vector<Posting> sorted(postings.size());
+        vector<uint32_t> fill(start.begin(), start.end() - 1);
+        for (auto &p : postings)
+            sorted[fill[p.fp & (buckets - 1)]++] = p;
+        postings.swap(sorted);
+        bucketStart.swap(start);
+    }
+
+    // Ids under fp that could be within maxEdits: each edit removes at most
+    // one distinct character and adds at most one
+    void lookup(uint32_t fp, uint32_t chars, size_t maxEdits, vector<uint32_t> &ids) const
+    {
+        auto take = [&](const Posting &p)
+        {
+            if (p.fp == fp && bitset<32>(p.chars & ~chars).count() <= maxEdits &&
+                bitset<32>(chars & ~p.chars).count() <= maxEdits)
+                ids.push_back(p.id);
+        };
+        if (!bucketStart.empty())
+        {
+            size_t b = fp & (bucketStart.size() - 2);
+            for (size_t k = bucketStart[b]; k < bucketStart[b + 1]; ++k)
+                take(postings[k]);
+        }
+        auto it = recent.find(fp);
+        if (it != recent.end())
+            for (auto &p : it->second)
+                take(p);
+    }
+};
+
+// ======== Plate Directory ========
+// Network-wide map of normalized plate -> lot it is parked in. Lots update it
+// from their own gate threads, so it is split into independently locked shards.
+class PlateDirectory
+{
+public:
+    void park(const string &plate, const string &lotId)
+    {
+        Shard &s = shardOf(plate);
+        lock_guard<mutex> lk(s.m);
+        s.lots[plate] = lotId;
+    }
+    // Only clears the entry if it still points at this lot
+    void leave(const string &plate, const string &lotId)
+    {
+        Shard &s = shardOf(plate);
+        lock_guard<mutex> lk(s.m);
+        auto it = s.lots.find(plate);
+        if (it != s.lots.end() && it->second == lotId)
+            s.lots.erase(it);
+    }
+    string lotOf(const string &plate)
+    {
+        Shard &s = shardOf(plate);
+        lock_guard<mutex> lk(s.m);
+        auto it = s.lots.find(plate);
+        return it == s.lots.end() ? "" : it->second;
+    }
+
+private:
+    static const size_t SHARDS = 64;
+    struct Shard
+    {
+        mutex m;
+        unordered_map<string, string> lots;
+    };
+    Shard shards[SHARDS];
+
+    Shard &shardOf(const string &plate) { return shards[hash<string>()(plate) % SHARDS]; }
+};
+
+// ======== Utility: Timestamps ========
+// Session times are stored as ctime() text ("Mon Oct 19 10:34:19 2026");
+// they're parsed once into seconds so stays can be measured and billed.
+long long daysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long yoe = y - era * 400;
+    long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468; // days since 1970-01-01
+}
+
+// Wall-clock seconds since 1970 (no time zone applied); -1 if unparseable
+long long parseTimestamp(const string &text)
+{
+    static const string months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    stringstream ss(text);
+    string wday, mon;
+    int day, h, mi, sec, year;
+    char c1, c2;
+    if (!(ss >> wday >> mon >> day >> h >> c1 >> mi >> c2 >> sec >> year) ||
+        c1 != ':' || c2 != ':' || mon.size() != 3 || months.find(mon) == string::npos)
+        return -1;
+    int month = months.find(mon) / 3 + 1;
+    return daysFromCivil(year, month, day) * 86400 + h * 3600 + mi * 60 + sec;
+}
+
+// Inverse of daysFromCivil()
+void civilFromDays(long long days, long long &y, int &m, int &d)
+{
+    long long z = days + 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097, doe = z - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp + (mp < 10 ? 3 : -9);
+    y = yoe + era * 400 + (m <= 2);
+}
+
+// "2026-10-19 10:30" for a parseTimestamp() value
+string formatTimestamp(long long secs)
+{
+    long long y;
+    int m, d;
+    civilFromDays(secs / 86400, y, m, d);
+    char buf[40];
+    snprintf(buf, sizeof buf, "%04lld-%02d-%02d %02lld:%02lld", y, m, d,
+             secs % 86400 / 3600, secs % 3600 / 60);
+    return buf;
+}
+
+// "2026-10-19 10:30" -> parseTimestamp() seconds; -1 if malformed
+long long parseDateTime(const string &text)
+{
+    stringstream ss(text);
+    int y, mo, d, h, mi;
+    char c1, c2, c3;
+    if (!(ss >> y >> c1 >> mo >> c2 >> d >> h >> c3 >> mi) || c1 != '-' || c2 != '-' ||
+        c3 != ':' || mo < 1 || mo > 12 || d < 1 || d > 31 || h < 0 || h > 23 || mi < 0 || mi > 59)
+        return -1;
+    return daysFromCivil(y, mo, d) * 86400 + h * 3600 + mi * 60;
+}
+
+// ctime()-style text ("Mon Oct 19 10:34:19 2026") for a parseTimestamp() value
+string formatCtime(long long secs)
+{
+    static const char *wdays[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    static const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    long long y;
+    int m, d;
+    civilFromDays(secs / 86400, y, m, d);
+    char buf[40];
+    snprintf(buf, sizeof buf, "%s %s %2d %02lld:%02lld:%02lld %lld", wdays[(secs / 86400 + 4) % 7],
+             months[m - 1], d, secs % 86400 / 3600, secs % 3600 / 60, secs % 60, y);
+    return buf;
+}
+
+// Unix epoch seconds -> parseTimestamp() value of the local time, i.e. what
+// the menus store via ctime(); localtime_r so ingest workers can share it.
+// -1 when the time can't be represented
+long long localWallSeconds(long long epoch)
+{
+    time_t t = epoch;
+    tm lt;
+#ifdef _WIN32
+    if (localtime_s(&lt, &t) != 0)
+        return -1;
+#else
+    if (!localtime_r(&t, &lt))
+        return -1;
+#endif
+    return daysFromCivil(lt.tm_year + 1900, lt.tm_mon + 1, lt.tm_mday) * 86400 +
+           lt.tm_hour * 3600 + lt.tm_min * 60 + lt.tm_sec;
+}
+
+// ======== Billing Engine ========
+// Per spot type: free grace period, first started hour, each further
+// started hour, and a cap per 24h. Amounts are whole currency units.
+struct Tariff
+{
+    int graceMinutes, firstHour, perHour, dailyCap;
+};
+
+class BillingEngine
+{
+public:
+    const string file = "tariffs.csv";
+
+    // Scratch networks bill on the built-in default and never create the file
+    explicit BillingEngine(bool persist = true)
+    {
+        if (persist)
+            load();
+    }
+
+    const Tariff &tariffFor(const string &type) const
+    {
+        auto it = tariffs.find(toLowerStr(type));
+        return it == tariffs.end() ? fallback : it->second;
+    }
+
+    long long sessionFee(const string &type, long long entry, long long exit) const
+    {
+        const Tariff &t = tariffFor(type);
+        int mins = stayMinutes(entry, exit);
+        long long fee;
+        feeColumn(&mins, &t.graceMinutes, &t.firstHour, &t.perHour, &t.dailyCap, &fee, 1);
+        return fee;
+    }
+
+    // Started minutes of a stay, clamped to the int32 minute columns
+    static int stayMinutes(long long entry, long long exit)
+    {
+        long long secs = exit - entry;
+        return secs > 0 ? (int)min<long long>((secs + 59) / 60, INT_MAX - 59) : 0;
+    }
+
+    // Column-at-a-time fee computation over int32 columns: stays arrive as
+    // minutes, the divisions are by constants (multiplies after lowering) and
+    // the conditionals are selects, so the loop vectorizes at -O3 (GCC 12:
+    // "loop vectorized using 32 byte vectors" with -march=x86-64-v3); only
+    // the final days * cap widens to 64 bits.
+    static void feeColumn(const int *minutes, const int *grace, const int *first,
+                          const int *perHour, const int *cap, long long *fee, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            int billable = minutes[i] > grace[i] ? minutes[i] : 0;
+            int hours = (billable + 59) / 60;
+            int days = hours / 24, rem = hours - days * 24;
+            int partial = rem > 0 ? first[i] + (rem - 1) * perHour[i] : 0;
+            partial = partial < cap[i] ? partial : cap[i];
+            fee[i] = (long long)days * cap[i] + partial;
+        }
+    }
+
+    void display() const
+    {
+        cout << "-- Tariffs (" << file << ") --\n";
+        for (auto &kv : tariffs)
+            cout << kv.first << ": grace " << kv.second.graceMinutes << "min, first hour "
+                 << kv.second.firstHour << ", then " << kv.second.perHour
+                 << "/h, cap " << kv.second.dailyCap << "/day\n";
+        cout << "other types: grace " << fallback.graceMinutes << "min, first hour "
+             << fallback.firstHour << ", then " << fallback.perHour
+             << "/h, cap " << fallback.dailyCap << "/day\n";
+    }
+
+private:
+    unordered_map<string, Tariff> tariffs; // lower-cased spot type -> tariff
+    Tariff fallback = {15, 500, 300, 5000};
+
+    void load()
+    {
+        ifstream f(file);
+        if (!f)
+        {
+            ofstream out(file);
+            out << "type,grace_minutes,first_hour,per_hour,daily_cap\n"
+                << "default,15,500,300,5000\n";
+            return;
+        }
+        string line;
+        getline(f, line);
+        while (getline(f, line))
+        {
+            stringstream ss(line);
+            string type, tok;
+            getline(ss, type, ',');
+            int v[4];
+            int n = 0;
+            while (n < 4 && getline(ss, tok, ',') && parseInt(tok, v[n]) && v[n] >= 0)
+                n++;
+            if (n < 4)
+                continue; // malformed row: the type keeps the default tariff
+            Tariff t = {v[0], v[1], v[2], v[3]};
+            if (toLowerStr(type) == "default")
+                fallback = t;
+            else
+                tariffs[toLowerStr(type)] = t;
+        }
+    }
 };
 
 // ======== ParkingLot Class ========
@@ -76,18 +855,76 @@ public:
     string lotId, name, location;
     Vehicle *vehicles = nullptr;
     ParkingSpot *spots = nullptr;
-    ParkingSession *sessions = nullptr;
+
+    // Only open sessions stay in memory; closed ones go to the archive
+    unordered_map<int, ParkingSession *> activeSessions;
+
+    // Owns every node above; freed in bulk with the lot
+    NodePool<Vehicle> vehiclePool;
+    NodePool<ParkingSpot> spotPool;
+    NodePool<ParkingSession> sessionPool;
 
     int nextSpotId = 1;
     int nextSessionId = 1;
 
+    // Spot lookup by ID and free spots per (lower-cased) type
+    unordered_map<int, ParkingSpot *> spotIndex;
+    unordered_map<string, FreeList> freeSpots;
+
+    // Keyed by normalizePlate(): vehicles, and the open session of each parked plate
+    unordered_map<string, Vehicle *> vehicleIndex;
+    unordered_map<string, int> activeByPlate;
+    PlateDirectory *directory = nullptr; // network-wide parked-plate index, if attached
+    PlateMatcher *matcher = nullptr;     // network-wide fuzzy index of registered plates
+
+    // Guards everything above. Gate threads go through gateEnter()/gateExit()
+    // and the batch calls, which take it; lots never share a lock.
+    mutex mtx;
+
+    // Free spots per type, readable without the lock. Types are interned into
+    // an append-only table whose entry is written before typeCount publishes it.
+    static const int MAX_SPOT_TYPES = 32;
+    string typeNames[MAX_SPOT_TYPES];
+    atomic<int> typeCount{0};
+    atomic<int> freeByType[MAX_SPOT_TYPES]{};
+
+    // False for scratch lots (the simulator): nothing is read from or written to disk
+    bool persistent = true;
+
     ParkingLot() = default;
-    ParkingLot(const string &id, const string &nm, const string &loc)
-        : lotId(id), name(nm), location(loc)
+    ParkingLot(const string &id, const string &nm, const string &loc, bool persist = true)
+        : lotId(id), name(nm), location(loc), persistent(persist)
     {
-        loadData();
+        if (persistent)
+        {
+            loadArchiveIndex();
+            loadData();
+            for (auto &part : archiveParts)
+                archiveBytesAtStart[part.first] = ifstream(archivePath(part.first), ios::ate).tellg();
+        }
         normalizeCounters();
         updateSpotStatuses();
+        if (persistent)
+            loadReservations();
+    }
+    ~ParkingLot()
+    {
+        if (directory)
+            for (auto &kv : activeByPlate)
+                directory->leave(kv.first, lotId);
+    }
+
+    // Publishes this lot's parked and registered plates to the network
+    // indexes and keeps them current from then on
+    void attachIndexes(PlateDirectory *dir, PlateMatcher *match)
+    {
+        lock_guard<mutex> lk(mtx);
+        directory = dir;
+        matcher = match;
+        for (auto &kv : activeByPlate)
+            directory->park(kv.first, lotId);
+        for (auto *v = vehicles; v; v = v->next)
+            matcher->add(v->id, lotId);
     }
 
     bool registerVehicle(const string &lp, const string &t, const string &own)
@@ -97,74 +934,439 @@ public:
             cout << "Vehicle already exists!\n";
             return false;
         }
-        vehicles = new Vehicle{lp, t, own, vehicles};
-        saveData();
+        vehicles = vehiclePool.create({lp, t, own, vehicles});
+        vehicleIndex[normalizePlate(lp)] = vehicles;
+        if (matcher)
+            matcher->add(lp, lotId);
+        if (batching && persistent)
+            pendingVehicles += lp + ',' + t + ',' + own + "\n";
+        persist();
         return true;
     }
 
     int addParkingSpot(const string &t)
     {
         int id = nextSpotId++;
-        spots = new ParkingSpot{id, t, false, spots};
+        spots = spotPool.create({id, t, false, spots});
+        spotIndex[id] = spots;
+        spotsByType[toLowerStr(t)].push_back(spots);
+        markFree(t, id);
         saveData();
         return id;
     }
 
     int startParkingSession(const string &vId, int sid, const string &entry)
     {
-        if (!findVehicle(vId) || !findSpot(sid))
-            return -1;
+        Vehicle *v = findVehicle(vId);
         ParkingSpot *spot = findSpot(sid);
+        if (!v || !spot)
+            return -1;
         if (spot->isOccupied)
             return -2;
+        long long now = parseTimestamp(entry);
+        const Reservation *r = reservationAt(sid, now);
+        if (r && normalizePlate(r->plate) != normalizePlate(v->id))
+            return -5;
+        if (r)
+            dropReservation(r->id); // the booking is used up
 
+        // Sessions record the plate as registered, whatever spelling was typed
         int id = nextSessionId++;
-        sessions = new ParkingSession{id, vId, sid, entry, "", sessions};
+        activeSessions[id] = sessionPool.create({id, v->id, sid, entry, "", parseTimestamp(entry)});
+        staysByEntry.insert({activeSessions[id]->entryEpoch, id});
+        string key = normalizePlate(v->id);
+        activeByPlate[key] = id;
+        if (directory)
+            directory->park(key, lotId);
         spot->isOccupied = true;
-        saveData();
+        markTaken(spot->type, sid);
+        persist();
         return id;
     }
 
+    // Gate entry: a vehicle with a booking running now gets its booked spot;
+    // anyone else gets a free spot of the type not booked within the next
+    // RESERVATION_HORIZON_MINUTES. -1 unknown vehicle, -3 lot full
+    int startSessionAnySpot(const string &vId, const string &type, const string &entry)
+    {
+        Vehicle *v = findVehicle(vId);
+        if (!v)
+            return -1;
+        long long now = parseTimestamp(entry);
+        auto own = reservationsByPlate.find(normalizePlate(v->id));
+        if (own != reservationsByPlate.end())
+            for (int rid : own->second)
+            {
+                const Reservation &r = reservationById(rid);
+                if (r.from <= now && now < r.to && !findSpot(r.spotId)->isOccupied)
+                    return startParkingSession(vId, r.spotId, entry);
+            }
+        auto it = freeSpots.find(toLowerStr(type));
+        if (it == freeSpots.end() || it->second.empty())
+            return -3;
+        const vector<int> &ids = it->second.ids;
+        if (reservationSpot.empty())
+            return startParkingSession(vId, ids.back(), entry);
+        for (size_t k = ids.size(); k-- > 0;)
+            if (!reservedDuring(ids[k], now, now + RESERVATION_HORIZON_MINUTES * 60))
+                return startParkingSession(vId, ids[k], entry);
+        return -3;
+    }
+
+    // --- Reservations ---
+    static const int RESERVATION_HORIZON_MINUTES = 120;
+
+    // Books a spot of the type for [from, to); reservation id, -1 unknown
+    // vehicle or bad window, -3 no spot of the type is free for the window
+    int reserveSpot(const string &plate, const string &type, long long from, long long to)
+    {
+        Vehicle *v = findVehicle(plate);
+        if (!v || from < 0 || to <= from)
+            return -1;
+        auto ofType = spotsByType.find(toLowerStr(type));
+        if (ofType == spotsByType.end())
+            return -3;
+        long long now = nowEpoch();
+        for (auto *s : ofType->second)
+            if (!reservedDuring(s->id, from, to) && !occupiedDuring(s, from, now))
+            {
+                Reservation r = {nextReservationId++, v->id, s->id, from, to};
+                addReservation(r);
+                saveReservations();
+                return r.id;
+            }
+        return -3;
+    }
+
+    bool cancelReservation(int rid)
+    {
+        if (!reservationSpot.count(rid))
+            return false;
+        dropReservation(rid);
+        return true;
+    }
+
+    // Spots of the type with no booking overlapping [from, to) (and, for a
+    // window starting now, not occupied): O(spots of the type * log bookings
+    // per spot)
+    int availableSpots(const string &type, long long from, long long to)
+    {
+        auto ofType = spotsByType.find(toLowerStr(type));
+        if (ofType == spotsByType.end())
+            return 0;
+        long long now = nowEpoch();
+        int n = 0;
+        for (auto *s : ofType->second)
+            n += !reservedDuring(s->id, from, to) && !occupiedDuring(s, from, now);
+        return n;
+    }
+
+    // --- Dashboard ---
+    // Snapshot of the counters kept up to date by the session hooks; costs
+    // O(spot types + top) whatever the number of sessions
+    struct DashboardRow
+    {
+        vector<pair<string, pair<int, int>>> types; // type -> (occupied, spots)
+        int occupied = 0, total = 0;
+        size_t exitsLastDay = 0;
+        vector<pair<string, long long>> longest; // plate -> entry
+    };
+
+    DashboardRow dashboard(long long now, size_t top = 3)
+    {
+        lock_guard<mutex> lk(mtx);
+        if (!exitsSeeded)
+            seedRecentExits(now);
+        DashboardRow row;
+        for (auto &kv : spotsByType)
+        {
+            auto it = freeSpots.find(kv.first);
+            int count = kv.second.size();
+            int taken = count - (it == freeSpots.end() ? 0 : (int)it->second.size());
+            row.types.push_back({kv.first, {taken, count}});
+            row.occupied += taken;
+            row.total += count;
+        }
+        while (!recentExits.empty() && recentExits.front() <= now - 86400)
+            recentExits.pop_front();
+        row.exitsLastDay = recentExits.size();
+        for (auto it = staysByEntry.begin(); it != staysByEntry.end() && row.longest.size() < top; ++it)
+            row.longest.push_back({activeSessions[it->second]->vehicleId, it->first});
+        return row;
+    }
+
+    void displayReservations()
+    {
+        cout << "-- Reservations in " << name << " (" << lotId << ") --\n";
+        for (auto &spot : reservations)
+            for (auto &kv : spot.second)
+                cout << kv.second.id << ": " << kv.second.plate << " @ S" << spot.first << " | "
+                     << formatTimestamp(kv.second.from) << " - " << formatTimestamp(kv.second.to) << "\n";
+    }
+    // What an open session would pay if it ended at `now`; -1 if unknown
+    long long quoteFee(int sessionId, long long now, const BillingEngine &billing)
+    {
+        ParkingSession *s = findSession(sessionId);
+        ParkingSpot *spot = s ? findSpot(s->spotId) : nullptr;
+        if (!s || s->entryEpoch < 0)
+            return -1;
+        return billing.sessionFee(spot ? spot->type : "", s->entryEpoch, now);
+    }
+
+    // --- Occupancy analytics: one sorted sweep over entry/exit events ---
+    struct OccupancyReport
+    {
+        long long firstBucket = 0;    // bucket number (epoch / BUCKET_SECONDS)
+        vector<int> peak, atEnd;      // per bucket: highest and closing occupancy
+        int maxOccupancy = 0;
+        long long maxAt = -1;
+        map<string, pair<long long, long long>> dwell; // type -> (seconds, sessions)
+        vector<pair<long long, int>> events;           // sorted (time, +1/-1), for merging
+    };
+    static const long long BUCKET_SECONDS = 15 * 60;
+
+    OccupancyReport computeOccupancy(long long now)
+    {
+        OccupancyReport r;
+        vector<pair<long long, int>> &events = r.events; // (time, +1 entry / -1 exit)
+        auto addStay = [&](const string &type, long long in, long long out, bool closed)
+        {
+            if (in < 0 || out < in)
+                return;
+            events.push_back({in, +1});
+            events.push_back({out, -1});
+            if (!closed)
+                return; // open stays count toward occupancy, not dwell
+            auto &d = r.dwell[toLowerStr(type)];
+            d.first += out - in;
+            d.second++;
+        };
+        for (auto &part : archiveParts)
+        {
+            ifstream f(archivePath(part.first));
+            string line;
+            getline(f, line);
+            while (getline(f, line))
+            {
+                vector<string> c = splitRow(line);
+                if (c.size() >= 6)
+                    addStay(c[3], parseTimestamp(c[4]), parseTimestamp(c[5]), true);
+            }
+        }
+        for (auto &kv : activeSessions)
+        {
+            ParkingSpot *spot = findSpot(kv.second->spotId);
+            addStay(spot ? spot->type : "", kv.second->entryEpoch, max(now, kv.second->entryEpoch), false);
+        }
+        sort(events.begin(), events.end()); // exits sort before entries at the same instant
+        sweepBuckets(r, now);
+        return r;
+    }
+
+    // Fills the per-bucket curve and the maximum from r.events (sorted)
+    static void sweepBuckets(OccupancyReport &r, long long now)
+    {
+        const vector<pair<long long, int>> &events = r.events;
+        if (events.empty())
+            return;
+        r.firstBucket = events.front().first / BUCKET_SECONDS;
+        long long last = max(now, events.back().first) / BUCKET_SECONDS;
+        r.peak.assign(last - r.firstBucket + 1, 0);
+        r.atEnd.assign(r.peak.size(), 0);
+        int cur = 0;
+        size_t b = 0;
+        for (auto &e : events)
+        {
+            size_t eb = e.first / BUCKET_SECONDS - r.firstBucket;
+            while (b < eb)
+            {
+                r.atEnd[b++] = cur;
+                r.peak[b] = cur;
+            }
+            cur += e.second;
+            if (cur > r.peak[b])
+                r.peak[b] = cur;
+            if (cur > r.maxOccupancy)
+            {
+                r.maxOccupancy = cur;
+                r.maxAt = e.first;
+            }
+        }
+        while (b < r.peak.size())
+        {
+            r.atEnd[b++] = cur;
+            if (b < r.peak.size())
+                r.peak[b] = cur;
+        }
+    }
+
+    // Reads one month's archive into columns for batch billing
+    void loadArchiveColumns(const string &part, vector<string> &plates, vector<string> &types,
+                            vector<long long> &entry, vector<long long> &exit)
+    {
+        if (!archiveParts.count(part))
+            return;
+        ifstream f(archivePath(part));
+        string line;
+        getline(f, line);
+        while (getline(f, line))
+        {
+            vector<string> c = splitRow(line);
+            if (c.size() < 6)
+                continue;
+            long long in = parseTimestamp(c[4]), out = parseTimestamp(c[5]);
+            if (in < 0 || out < 0)
+                continue;
+            plates.push_back(c[1]);
+            types.push_back(c[3]);
+            entry.push_back(in);
+            exit.push_back(out);
+        }
+    }
+
+    int spotOfSession(int sessionId)
+    {
+        ParkingSession *s = findSession(sessionId);
+        return s ? s->spotId : -1;
+    }
+    // Lock-free unless the type table has overflowed
+    size_t freeSpotCount(const string &type)
+    {
+        string key = toLowerStr(type);
+        int slot = typeSlot(key);
+        if (slot >= 0)
+            return freeByType[slot].load(memory_order_acquire);
+        if (typeCount.load(memory_order_acquire) < MAX_SPOT_TYPES)
+            return 0; // no spot of this type was ever added
+        lock_guard<mutex> lk(mtx);
+        auto it = freeSpots.find(key);
+        return it == freeSpots.end() ? 0 : it->second.size();
+    }
+
+    // Thread-safe gate entry. A full lot is rejected on the atomic counter
+    // without locking; the counter is re-checked through the free list under
+    // the lock, so two gates can never take the same spot. Returns the
+    // session id, -3 if no spot is free, -4 if the plate is already inside.
+    int gateEnter(const string &plate, const string &type, const string &when)
+    {
+        if (!type.empty() && freeSpotCount(type) == 0)
+            return -3;
+        lock_guard<mutex> lk(mtx);
+        if (sessionOfPlate(plate) >= 0)
+            return -4;
+        string vtype = vehicleType(plate);
+        if (vtype.empty())
+        {
+            vtype = type.empty() ? "car" : type;
+            registerVehicle(plate, vtype, "gate");
+        }
+        return startSessionAnySpot(plate, type.empty() ? vtype : type, when);
+    }
+
+    bool gateExit(const string &plate, const string &when)
+    {
+        lock_guard<mutex> lk(mtx);
+        int sid = sessionOfPlate(plate);
+        return sid >= 0 && endParkingSession(sid, when);
+    }
+
     bool endParkingSession(int sessionId, const string &exit)
     {
         ParkingSession *session = findSession(sessionId);
-        if (!session || session->exitTime != "")
+        if (!session)
             return false;
 
         session->exitTime = exit;
-        ParkingSpot *spot = findSpot(session->spotId);
-        if (spot)
-            spot->isOccupied = false;
-        saveData();
+        session->exitEpoch = parseTimestamp(exit);
+        recentExits.push_back(session->exitEpoch);
+        while (recentExits.front() <= recentExits.back() - 86400)
+            recentExits.pop_front();
+        releaseSpot(session->spotId);
+        archiveSession(*session);
+        forgetSession(session);
+        persist();
         return true;
     }
 
+    // Registered type of a plate, or "" if the vehicle is unknown
+    string vehicleType(const string &plate)
+    {
+        Vehicle *v = findVehicle(plate);
+        return v ? v->type : "";
+    }
+
+    // Open session of a plate, or -1
+    int sessionOfPlate(const string &plate) const
+    {
+        auto it = activeByPlate.find(normalizePlate(plate));
+        return it == activeByPlate.end() ? -1 : it->second;
+    }
+
+    // Group commit: between beginBatch() and commitBatch() the gate-path
+    // mutations only touch memory and queue their appends. commitBatch()
+    // appends new vehicles and archive rows and rewrites the spot and open
+    // session files once for the whole batch.
+    // Returns false if the lot is already in a batch
+    bool beginBatch()
+    {
+        lock_guard<mutex> lk(mtx);
+        if (batching)
+            return false;
+        batching = true;
+        return true;
+    }
+    void commitBatch()
+    {
+        lock_guard<mutex> lk(mtx);
+        batching = false;
+        if (!pendingVehicles.empty())
+        {
+            string fn = lotId + "_vehicles.csv";
+            bool fresh = !ifstream(fn).good();
+            ofstream f(fn, ios::app);
+            if (fresh)
+                f << "license_plate,type,owner\n";
+            f << pendingVehicles;
+            pendingVehicles.clear();
+        }
+        flushArchive();
+        if (dirty)
+        {
+            saveSpots(lotId + "_spots.csv");
+            saveSessions(lotId + "_sessions.csv");
+            dirty = false;
+        }
+    }
+
     // Delete functions
     bool deleteVehicle(const string &vId)
     {
-        Vehicle **ptr = &vehicles;
-        while (*ptr)
+        string key = normalizePlate(vId);
+        Vehicle *v = findVehicle(key);
+        if (!v)
+            return false;
+        if (activeByPlate.count(key))
         {
-            if ((*ptr)->id == vId)
-            {
-                // Check for active sessions
-                for (auto *s = sessions; s; s = s->next)
-                {
-                    if (s->vehicleId == vId && s->exitTime == "")
-                    {
-                        cout << "Cannot delete vehicle with active session\n";
-                        return false;
-                    }
-                }
-                Vehicle *temp = *ptr;
-                *ptr = temp->next;
-                delete temp;
-                saveData();
-                return true;
-            }
-            ptr = &(*ptr)->next;
+            cout << "Cannot delete vehicle with active session\n";
+            return false;
         }
-        return false;
+        // O(1) unlink: the list is unordered, so move the head's data into
+        // the victim's node and drop the head instead
+        Vehicle *head = vehicles;
+        vehicleIndex.erase(key);
+        if (matcher)
+            matcher->forget(v->id, lotId);
+        if (head != v)
+        {
+            v->id = head->id;
+            v->type = head->type;
+            v->owner = head->owner;
+            vehicleIndex[normalizePlate(v->id)] = v;
+        }
+        vehicles = head->next;
+        vehiclePool.release(head);
+        saveData();
+        return true;
     }
 
     bool deleteSpot(int sid)
@@ -179,9 +1381,20 @@ public:
                     cout << "Cannot delete occupied spot\n";
                     return false;
                 }
+                if (reservations.count(sid))
+                {
+                    cout << "Cannot delete reserved spot\n";
+                    return false;
+                }
                 ParkingSpot *temp = *ptr;
                 *ptr = temp->next;
-                delete temp;
+                auto ofType = spotsByType.find(toLowerStr(temp->type));
+                ofType->second.erase(find(ofType->second.begin(), ofType->second.end(), temp));
+                if (ofType->second.empty())
+                    spotsByType.erase(ofType);
+                markTaken(temp->type, sid);
+                spotIndex.erase(sid);
+                spotPool.release(temp);
                 saveData();
                 return true;
             }
@@ -190,26 +1403,17 @@ public:
         return false;
     }
 
+    // Only open sessions can be deleted; the archive is append-only
     bool deleteSession(int sid)
     {
-        ParkingSession **ptr = &sessions;
-        while (*ptr)
-        {
-            if ((*ptr)->id == sid)
-            {
-                ParkingSession *temp = *ptr;
-                // Free up the parking spot
-                ParkingSpot *spot = findSpot(temp->spotId);
-                if (spot)
-                    spot->isOccupied = false;
-                *ptr = temp->next;
-                delete temp;
-                saveData();
-                return true;
-            }
-            ptr = &(*ptr)->next;
-        }
-        return false;
+        ParkingSession *temp = findSession(sid);
+        if (!temp)
+            return false;
+        // Free up the parking spot
+        releaseSpot(temp->spotId);
+        forgetSession(temp);
+        saveData();
+        return true;
     }
 
     void displayVehicles()
@@ -231,79 +1435,406 @@ public:
     void displaySessions(bool currentOnly = false)
     {
         cout << "-- Parking Sessions in " << name << " (" << lotId << ") --\n";
-        for (auto *s = sessions; s; s = s->next)
+        if (!currentOnly)
+        {
+            // Streamed from the archive, oldest partition first
+            for (auto &part : archiveParts)
+            {
+                ifstream f(archivePath(part.first));
+                string line;
+                getline(f, line);
+                while (getline(f, line))
+                {
+                    vector<string> c = splitRow(line);
+                    if (c.size() >= 6)
+                        cout << c[0] << ": " << c[1] << " @ S" << c[2] << " | "
+                             << c[4] << " - " << c[5] << "\n";
+                }
+            }
+        }
+        for (auto &kv : activeSessions)
         {
-            if (!currentOnly || s->exitTime == "")
-                cout << s->id << ": " << s->vehicleId << " @ S" << s->spotId
-                     << " | " << s->entryTime << " - "
-                     << (s->exitTime == "" ? "Ongoing" : s->exitTime) << "\n";
+            ParkingSession *s = kv.second;
+            cout << s->id << ": " << s->vehicleId << " @ S" << s->spotId
+                 << " | " << s->entryTime << " - Ongoing\n";
         }
     }
 
+    // Removes every file belonging to this lot, archive partitions included
+    void deleteFiles()
+    {
+        remove((lotId + "_vehicles.csv").c_str());
+        remove((lotId + "_spots.csv").c_str());
+        remove((lotId + "_sessions.csv").c_str());
+        for (auto &part : archiveParts)
+            remove(archivePath(part.first).c_str());
+        remove((lotId + "_archive_index.csv").c_str());
+        remove((lotId + "_reservations.csv").c_str());
+    }
+
     void loadData()
     {
-        loadList<Vehicle>(lotId + "_vehicles.csv", vehicles);
-        loadList<ParkingSpot>(lotId + "_spots.csv", spots);
-        loadList<ParkingSession>(lotId + "_sessions.csv", sessions);
+        loadList<Vehicle>(lotId + "_vehicles.csv", vehicles, vehiclePool);
+        loadList<ParkingSpot>(lotId + "_spots.csv", spots, spotPool);
+        loadSessions(lotId + "_sessions.csv");
     }
 
     void saveData()
     {
+        if (!persistent)
+            return;
         saveVehicles(lotId + "_vehicles.csv");
         saveSpots(lotId + "_spots.csv");
         saveSessions(lotId + "_sessions.csv");
     }
 
 private:
+    // Archive partitions by closing month: "YYYY-MM" -> (sessions, max session id)
+    map<string, pair<int, int>> archiveParts;
+
+    // Bookings per spot as disjoint intervals keyed by start, so an overlap
+    // test only has to look at the last booking starting before the window ends
+    unordered_map<int, map<long long, Reservation>> reservations;
+    unordered_map<int, int> reservationSpot;               // reservation id -> spot
+    unordered_map<string, vector<int>> reservationsByPlate; // normalized plate -> ids
+    int nextReservationId = 1;
+
+    // Dashboard state, maintained by the session and spot hooks
+    map<string, vector<ParkingSpot *>> spotsByType; // lower-cased type -> spots
+    set<pair<long long, int>> staysByEntry;    // open sessions by (entry, id)
+    deque<long long> recentExits;              // exit times within the last day
+    map<string, long long> archiveBytesAtStart; // partition -> size before this process wrote to it
+    bool exitsSeeded = false;
+
+    // Exits archived before this process started, read once from the
+    // partitions covering the last day and merged in. Only the bytes present
+    // at startup are read: later rows are already in recentExits.
+    void seedRecentExits(long long now)
+    {
+        exitsSeeded = true;
+        vector<long long> old;
+        string parts[2] = {formatTimestamp(now - 86400).substr(0, 7), formatTimestamp(now).substr(0, 7)};
+        for (int i = 0; i < 2; ++i)
+        {
+            if ((i == 1 && parts[1] == parts[0]) || !archiveParts.count(parts[i]))
+                continue;
+            auto size = archiveBytesAtStart.find(parts[i]);
+            if (size == archiveBytesAtStart.end() || size->second <= 0)
+                continue;
+            string text(size->second, '\0');
+            ifstream(archivePath(parts[i])).read(&text[0], text.size());
+            istringstream in(text);
+            string line;
+            getline(in, line);
+            while (getline(in, line))
+            {
+                vector<string> c = splitRow(line);
+                if (c.size() < 6)
+                    continue;
+                long long out = parseTimestamp(c[5]);
+                if (out > now - 86400)
+                    old.push_back(out);
+            }
+        }
+        sort(old.begin(), old.end());
+        deque<long long> merged(old.size() + recentExits.size());
+        merge(old.begin(), old.end(), recentExits.begin(), recentExits.end(), merged.begin());
+        recentExits.swap(merged);
+    }
+
+    bool reservedDuring(int sid, long long from, long long to) const
+    {
+        auto s = reservations.find(sid);
+        if (s == reservations.end())
+            return false;
+        auto it = s->second.lower_bound(to);
+        return it != s->second.begin() && prev(it)->second.to > from;
+    }
+    const Reservation *reservationAt(int sid, long long t) const
+    {
+        auto s = reservations.find(sid);
+        if (s == reservations.end())
+            return nullptr;
+        auto it = s->second.upper_bound(t);
+        if (it == s->second.begin() || prev(it)->second.to <= t)
+            return nullptr;
+        return &prev(it)->second;
+    }
+    // Open sessions have no end yet, so they block any window starting by
+    // now; callers read the clock once per scan
+    static bool occupiedDuring(const ParkingSpot *s, long long from, long long now)
+    {
+        return s->isOccupied && from <= now;
+    }
+    static long long nowEpoch()
+    {
+        time_t t = time(0);
+        return parseTimestamp(ctime(&t));
+    }
+    const Reservation &reservationById(int rid) const
+    {
+        int sid = reservationSpot.at(rid);
+        for (auto &kv : reservations.at(sid))
+            if (kv.second.id == rid)
+                return kv.second;
+        throw out_of_range("reservation");
+    }
+    void addReservation(const Reservation &r)
+    {
+        reservations[r.spotId][r.from] = r;
+        reservationSpot[r.id] = r.spotId;
+        reservationsByPlate[normalizePlate(r.plate)].push_back(r.id);
+        nextReservationId = max(nextReservationId, r.id + 1);
+    }
+    void dropReservation(int rid)
+    {
+        const Reservation r = reservationById(rid);
+        auto &bySpot = reservations[r.spotId];
+        bySpot.erase(r.from);
+        if (bySpot.empty())
+            reservations.erase(r.spotId);
+        reservationSpot.erase(rid);
+        auto &mine = reservationsByPlate[normalizePlate(r.plate)];
+        mine.erase(remove(mine.begin(), mine.end(), rid), mine.end());
+        if (mine.empty())
+            reservationsByPlate.erase(normalizePlate(r.plate));
+        saveReservations();
+    }
+
+    // Bookings that have already ended are dropped on load
+    void loadReservations()
+    {
+        ifstream f(lotId + "_reservations.csv");
+        string line;
+        getline(f, line);
+        time_t t = time(0);
+        long long now = parseTimestamp(ctime(&t));
+        while (getline(f, line))
+        {
+            vector<string> c = splitRow(line);
+            if (c.size() < 5)
+                continue;
+            Reservation r = {stoi(c[0]), c[1], stoi(c[2]), parseDateTime(c[3]), parseDateTime(c[4])};
+            if (r.to > now && findSpot(r.spotId) && !reservedDuring(r.spotId, r.from, r.to))
+                addReservation(r);
+        }
+    }
+    void saveReservations()
+    {
+        if (!persistent)
+            return;
+        ofstream f(lotId + "_reservations.csv");
+        f << "id,plate,spot_id,from,to\n";
+        for (auto &spot : reservations)
+            for (auto &kv : spot.second)
+                f << kv.second.id << ',' << kv.second.plate << ',' << spot.first << ','
+                  << formatTimestamp(kv.second.from) << ',' << formatTimestamp(kv.second.to) << "\n";
+    }
+
+    // Group-commit state; see beginBatch()
+    bool batching = false, dirty = false;
+    string pendingVehicles;
+    map<string, string> pendingArchive; // partition -> rows to append
+
+    int typeSlot(const string &key) const
+    {
+        int n = typeCount.load(memory_order_acquire);
+        for (int i = 0; i < n; ++i)
+            if (typeNames[i] == key)
+                return i;
+        return -1;
+    }
+    // Mirrors a free list's size into its atomic counter (callers hold mtx)
+    void publishFree(const string &key, size_t n)
+    {
+        int slot = typeSlot(key);
+        if (slot < 0)
+        {
+            slot = typeCount.load(memory_order_relaxed);
+            if (slot == MAX_SPOT_TYPES)
+                return;
+            typeNames[slot] = key;
+            typeCount.store(slot + 1, memory_order_release);
+        }
+        freeByType[slot].store(n, memory_order_release);
+    }
+    void markFree(const string &type, int id)
+    {
+        string key = toLowerStr(type);
+        FreeList &l = freeSpots[key];
+        l.push(id);
+        publishFree(key, l.size());
+    }
+    void markTaken(const string &type, int id)
+    {
+        string key = toLowerStr(type);
+        FreeList &l = freeSpots[key];
+        l.erase(id);
+        publishFree(key, l.size());
+    }
+
+    void persist()
+    {
+        if (!persistent)
+            return;
+        if (batching)
+            dirty = true;
+        else
+            saveData();
+    }
+
+    void forgetSession(ParkingSession *s)
+    {
+        string key = normalizePlate(s->vehicleId);
+        auto it = activeByPlate.find(key);
+        if (it != activeByPlate.end() && it->second == s->id)
+        {
+            activeByPlate.erase(it);
+            if (directory)
+                directory->leave(key, lotId);
+        }
+        staysByEntry.erase({s->entryEpoch, s->id});
+        activeSessions.erase(s->id);
+        sessionPool.release(s);
+    }
+
+    string archivePath(const string &part) const { return lotId + "_archive_" + part + ".csv"; }
+
+    // "Mon Oct 19 10:34:19 2026" -> "2026-10"
+    static string partitionOf(const string &ctimeStr)
+    {
+        static const string months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+        stringstream ss(ctimeStr);
+        string wday, mon, day, clock, year;
+        ss >> wday >> mon >> day >> clock >> year;
+        size_t m = months.find(mon);
+        if (year.size() != 4 || mon.size() != 3 || m == string::npos)
+            return "unknown";
+        int month = m / 3 + 1;
+        return year + (month < 10 ? "-0" : "-") + to_string(month);
+    }
+
+    void archiveSession(const ParkingSession &s)
+    {
+        string part = partitionOf(s.exitTime);
+        string &rows = pendingArchive[part];
+        if (!archiveParts.count(part))
+            rows += "id,vehicle_id,spot_id,spot_type,entry_time,exit_time\n";
+        ParkingSpot *spot = findSpot(s.spotId);
+        rows += to_string(s.id) + ',' + s.vehicleId + ',' + to_string(s.spotId) + ',' +
+                (spot ? spot->type : "") + ',' + s.entryTime + ',' + s.exitTime + "\n";
+        auto &stats = archiveParts[part];
+        stats.first++;
+        stats.second = max(stats.second, s.id);
+        if (!batching)
+            flushArchive();
+    }
+
+    void flushArchive()
+    {
+        if (pendingArchive.empty())
+            return;
+        if (persistent)
+        {
+            for (auto &part : pendingArchive)
+                ofstream(archivePath(part.first), ios::app) << part.second;
+            saveArchiveIndex();
+        }
+        pendingArchive.clear();
+    }
+
+    void loadArchiveIndex()
+    {
+        ifstream f(lotId + "_archive_index.csv");
+        string line;
+        getline(f, line);
+        while (getline(f, line))
+        {
+            vector<string> c = splitRow(line);
+            if (c.size() >= 3)
+                archiveParts[c[0]] = {stoi(c[1]), stoi(c[2])};
+        }
+    }
+    void saveArchiveIndex()
+    {
+        ofstream f(lotId + "_archive_index.csv");
+        f << "partition,sessions,max_session_id\n";
+        for (auto &part : archiveParts)
+            f << part.first << ',' << part.second.first << ',' << part.second.second << "\n";
+    }
+
+    static vector<string> splitRow(const string &line)
+    {
+        stringstream ss(line);
+        vector<string> cols;
+        string tok;
+        while (getline(ss, tok, ','))
+            cols.push_back(tok);
+        return cols;
+    }
+
     Vehicle *findVehicle(const string &vId)
     {
-        for (auto *v = vehicles; v; v = v->next)
-            if (v->id == vId)
-                return v;
-        return nullptr;
+        auto it = vehicleIndex.find(normalizePlate(vId));
+        return it == vehicleIndex.end() ? nullptr : it->second;
     }
 
     ParkingSpot *findSpot(int id)
     {
-        for (auto *s = spots; s; s = s->next)
-            if (s->id == id)
-                return s;
-        return nullptr;
+        auto it = spotIndex.find(id);
+        return it == spotIndex.end() ? nullptr : it->second;
+    }
+    void releaseSpot(int sid)
+    {
+        ParkingSpot *spot = findSpot(sid);
+        if (!spot)
+            return;
+        spot->isOccupied = false;
+        markFree(spot->type, sid);
     }
 
     ParkingSession *findSession(int id)
     {
-        for (auto *s = sessions; s; s = s->next)
-            if (s->id == id)
-                return s;
-        return nullptr;
+        auto it = activeSessions.find(id);
+        return it == activeSessions.end() ? nullptr : it->second;
     }
 
+    // Cost is O(spots + open sessions), independent of history length
     void updateSpotStatuses()
     {
         unordered_set<int> occupiedSpots;
-        for (auto *s = sessions; s; s = s->next)
-        {
-            if (s->exitTime == "")
-            {
-                occupiedSpots.insert(s->spotId);
-            }
-        }
+        for (auto &kv : activeSessions)
+            occupiedSpots.insert(kv.second->spotId);
+        spotIndex.clear();
+        freeSpots.clear();
+        spotsByType.clear();
         for (auto *spot = spots; spot; spot = spot->next)
         {
             spot->isOccupied = occupiedSpots.count(spot->id);
+            spotIndex[spot->id] = spot;
+            spotsByType[toLowerStr(spot->type)].push_back(spot);
+            if (!spot->isOccupied)
+                freeSpots[toLowerStr(spot->type)].push(spot->id);
         }
+        for (auto &kv : freeSpots)
+            publishFree(kv.first, kv.second.size());
     }
 
     template <typename T>
-    void loadList(const string &fn, T *&head)
+    void loadList(const string &fn, T *&head, NodePool<T> &pool)
     {
         ifstream f(fn);
         if (!f)
             return;
+        // Read the file once and reserve one block for all of its rows
+        stringstream buf;
+        buf << f.rdbuf();
+        string text = buf.str();
+        pool.reserve(count(text.begin(), text.end(), '\n'));
+        istringstream in(text);
         string line;
-        getline(f, line);
-        while (getline(f, line))
+        getline(in, line);
+        while (getline(in, line))
         {
             stringstream ss(line);
             vector<string> cols;
@@ -313,18 +1844,53 @@ private:
 
             if constexpr (is_same<T, Vehicle>::value)
             {
-                head = new Vehicle{cols[0], cols[1], cols[2], head};
+                head = pool.create({cols[0], cols[1], cols[2], head});
+                vehicleIndex[normalizePlate(head->id)] = head;
             }
-            else if constexpr (is_same<T, ParkingSpot>::value)
+            else
             {
-                head = new ParkingSpot{stoi(cols[0]), cols[1], cols[2] == "1", head};
+                head = pool.create({stoi(cols[0]), cols[1], cols[2] == "1", head});
+                spotIndex[head->id] = head;
+            }
+        }
+    }
+
+    // Open sessions only; closed rows left by older versions are moved to the
+    // archive once
+    void loadSessions(const string &fn)
+    {
+        ifstream f(fn);
+        if (!f)
+            return;
+        string line;
+        getline(f, line);
+        bool migrated = false;
+        bool wasBatching = batching;
+        batching = true; // migrated rows go out in one append per partition
+        while (getline(f, line))
+        {
+            vector<string> cols = splitRow(line);
+            ParkingSession s = {stoi(cols[0]), cols[1], stoi(cols[2]), cols[3],
+                                cols.size() > 4 ? cols[4] : ""};
+            s.entryEpoch = parseTimestamp(s.entryTime);
+            s.exitEpoch = parseTimestamp(s.exitTime);
+            if (s.exitTime != "")
+            {
+                archiveSession(s);
+                migrated = true;
             }
             else
             {
-                head = new ParkingSession{stoi(cols[0]), cols[1],
-                                          stoi(cols[2]), cols[3], cols[4], head};
+                activeSessions[s.id] = sessionPool.create(s);
+                activeByPlate[normalizePlate(s.vehicleId)] = s.id;
+                staysByEntry.insert({s.entryEpoch, s.id});
             }
         }
+        f.close();
+        batching = wasBatching;
+        flushArchive(); // archived before the rows leave the sessions file
+        if (migrated)
+            saveSessions(fn);
     }
 
     void saveVehicles(const string &fn)
@@ -347,17 +1913,22 @@ private:
     {
         ofstream f(fn);
         f << "id,vehicle_id,spot_id,entry_time,exit_time\n";
-        for (auto *s = sessions; s; s = s->next)
+        for (auto &kv : activeSessions)
+        {
+            ParkingSession *s = kv.second;
             f << s->id << ',' << s->vehicleId << ',' << s->spotId << ','
               << s->entryTime << ',' << s->exitTime << "\n";
+        }
     }
 
     void normalizeCounters()
     {
         for (auto *s = spots; s; s = s->next)
             nextSpotId = max(nextSpotId, s->id + 1);
-        for (auto *s = sessions; s; s = s->next)
-            nextSessionId = max(nextSessionId, s->id + 1);
+        for (auto &kv : activeSessions)
+            nextSessionId = max(nextSessionId, kv.first + 1);
+        for (auto &part : archiveParts)
+            nextSessionId = max(nextSessionId, part.second.second + 1);
     }
 };
 
@@ -379,11 +1950,25 @@ public:
     unordered_map<string, ParkingLot *> nodes;
     unordered_map<string, vector<pair<string, int>>> adj;
     int nextLotIndex = 1;
+    BillingEngine billing;
+    PlateDirectory plates;
+    PlateMatcher plateMatcher;
+
+    // A non-persistent network starts empty and never touches the CSV files
+    bool persistent = true;
 
-    ParkingNetwork()
+    explicit ParkingNetwork(bool persist = true) : billing(persist), persistent(persist)
+    {
+        if (persistent)
+        {
+            loadLots();
+            loadConnections();
+        }
+    }
+    ~ParkingNetwork()
     {
-        loadLots();
-        loadConnections();
+        for (auto &kv : nodes)
+            delete kv.second;
     }
 
     void addParkingLot()
@@ -394,11 +1979,20 @@ public:
         cout << "Location: ";
         string loc;
         getline(cin, loc);
+        cout << "Added: " << createLot(nm, loc) << "\n";
+    }
+
+    string createLot(const string &nm, const string &loc)
+    {
         string id = genId();
-        nodes[id] = new ParkingLot(id, nm, loc);
-        saveLots();
-        saveConnections();
-        cout << "Added: " << id << "\n";
+        nodes[id] = new ParkingLot(id, nm, loc, persistent);
+        nodes[id]->attachIndexes(&plates, &plateMatcher);
+        if (persistent)
+        {
+            saveLots();
+            saveConnections();
+        }
+        return id;
     }
 
     void updateParkingLot()
@@ -477,9 +2071,7 @@ public:
         }
 
         // Delete associated files
-        remove((id + "_vehicles.csv").c_str());
-        remove((id + "_spots.csv").c_str());
-        remove((id + "_sessions.csv").c_str());
+        nodes[id]->deleteFiles();
 
         // Remove from network
         delete nodes[id];
@@ -519,11 +2111,16 @@ public:
             cout << "Lots are already connected.\n";
             return;
         }
-        int dist = readInt("Distance (meters): ", 0);
+        link(a, b, readInt("Distance (meters): ", 0));
+        cout << "Connected " << a << " <-> " << b << "\n";
+    }
+
+    void link(const string &a, const string &b, int dist)
+    {
         adj[a].push_back({b, dist});
         adj[b].push_back({a, dist});
-        saveConnections();
-        cout << "Connected " << a << " <-> " << b << "\n";
+        if (persistent)
+            saveConnections();
     }
 
     void listParkingLots()
@@ -546,6 +2143,341 @@ public:
         }
     }
 
+    // Occupancy per lot and type, turnover over the last day and the longest
+    // current stays, from each lot's incrementally kept counters: O(lots)
+    string renderDashboard(long long now)
+    {
+        vector<string> ids;
+        for (auto &kv : nodes)
+            ids.push_back(kv.first);
+        sort(ids.begin(), ids.end());
+        ostringstream out;
+        out << "-- Dashboard " << formatTimestamp(now) << " --\n";
+        int occupied = 0, total = 0;
+        size_t exits = 0;
+        for (auto &id : ids)
+        {
+            ParkingLot *lot = nodes[id];
+            ParkingLot::DashboardRow row = lot->dashboard(now);
+            occupied += row.occupied;
+            total += row.total;
+            exits += row.exitsLastDay;
+            out << id << " " << lot->name << ": " << row.occupied << "/" << row.total;
+            if (row.total)
+                out << " (" << row.occupied * 100 / row.total << "%)";
+            for (auto &t : row.types)
+                out << " | " << t.first << " " << t.second.first << "/" << t.second.second;
+            out << " | turnover " << row.exitsLastDay;
+            if (row.total)
+                out << " (" << row.exitsLastDay / (double)row.total << "/spot)";
+            out << "\n";
+            for (auto &stay : row.longest)
+            {
+                long long mins = max(0LL, now - stay.second) / 60;
+                out << "    " << stay.first << " " << mins / 60 << "h" << mins % 60 << "m\n";
+            }
+        }
+        out << "Network: " << occupied << "/" << total << " occupied, " << exits
+            << " exit(s) in the last 24h\n";
+        return out.str();
+    }
+
+    void showDashboard()
+    {
+        int secs = readInt("Refresh for how many seconds (0 = once): ", 0);
+        auto next = chrono::steady_clock::now();
+        for (int i = 0; i <= secs; ++i)
+        {
+            time_t t = time(0);
+            if (secs)
+                cout << "\033[2J\033[H"; // clear the terminal between frames
+            cout << renderDashboard(parseTimestamp(ctime(&t))) << flush;
+            next += chrono::seconds(1);
+            if (i < secs)
+                this_thread::sleep_until(next);
+        }
+    }
+
+    // --- Gate event ingestion ---
+    // One event per line: plate,lot,IN|OUT,timestamp[,spot_type], with the
+    // timestamp in Unix seconds or ctime() text. Lines are sharded by lot
+    // across worker threads, so each lot's events stay in order and workers
+    // never contend for a lot. A batch is applied and committed once it is
+    // full or the input has nothing more buffered, so a quiet pipe never
+    // holds events back.
+    static const size_t INGEST_BATCH_EVENTS = 4096;
+    struct IngestStats
+    {
+        size_t applied = 0, rejected = 0;
+    };
+
+    IngestStats ingestEvents(istream &in, size_t batchSize = INGEST_BATCH_EVENTS, unsigned workers = 0)
+    {
+        if (workers == 0)
+            workers = max(1u, thread::hardware_concurrency());
+        IngestStats st;
+        vector<vector<string>> shards(workers);
+        size_t pending = 0;
+        auto flush = [&]()
+        {
+            vector<IngestStats> part(workers);
+            auto run = [&](unsigned w)
+            {
+                part[w] = applyShard(shards[w]);
+                shards[w].clear();
+            };
+            vector<thread> pool;
+            for (unsigned w = 1; w < workers; ++w)
+                if (!shards[w].empty())
+                    pool.emplace_back(run, w);
+            run(0);
+            for (auto &th : pool)
+                th.join();
+            for (auto &p : part)
+            {
+                st.applied += p.applied;
+                st.rejected += p.rejected;
+            }
+            pending = 0;
+        };
+        hash<string> shardOf;
+        string line;
+        while (getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty() || line.compare(0, 6, "plate,") == 0)
+                continue;
+            size_t a = line.find(','), b = a == string::npos ? a : line.find(',', a + 1);
+            string lot = b == string::npos ? "" : line.substr(a + 1, b - a - 1);
+            shards[shardOf(lot) % workers].push_back(move(line));
+            if (++pending >= batchSize || in.rdbuf()->in_avail() <= 0)
+                flush();
+        }
+        flush();
+        return st;
+    }
+
+    // With `watch`, the dashboard is reprinted every second while the feed runs
+    void ingestFile(const string &path, bool watch = false)
+    {
+        ifstream f(path);
+        if (!f)
+        {
+            cout << "Cannot open " << path << "\n";
+            return;
+        }
+        auto t0 = chrono::steady_clock::now();
+        atomic<bool> done{false};
+        thread ticker;
+        if (watch)
+            ticker = thread([&]()
+                            {
+                while (!done)
+                {
+                    time_t t = time(0);
+                    cout << renderDashboard(parseTimestamp(ctime(&t))) << flush;
+                    for (int i = 0; i < 10 && !done; ++i)
+                        this_thread::sleep_for(chrono::milliseconds(100));
+                } });
+        IngestStats st = ingestEvents(f);
+        done = true;
+        if (ticker.joinable())
+            ticker.join();
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        cout << "Applied " << st.applied << " event(s), rejected " << st.rejected;
+        if (secs > 0)
+            cout << " (" << (long long)((st.applied + st.rejected) / secs) << " events/sec)";
+        cout << "\n";
+    }
+
+    // Monthly invoicing: every lot's archive partition for the month is loaded
+    // into columns, tariffs are gathered per row, and fees are computed in
+    // one columnar pass before being summed per vehicle.
+    void runBilling()
+    {
+        cout << "Month (YYYY-MM): ";
+        string month;
+        getline(cin, month);
+        billing.display();
+        string out = "invoice_" + month + ".csv";
+        ofstream f(out);
+        f << "lot,vehicle,sessions,total\n";
+        size_t totalSessions = 0;
+        long long grandTotal = 0;
+        for (auto &kv : nodes)
+        {
+            vector<string> plates, types;
+            vector<long long> entry, exit;
+            kv.second->loadArchiveColumns(month, plates, types, entry, exit);
+            size_t n = plates.size();
+            vector<int> minutes(n), grace(n), first(n), perHour(n), cap(n);
+            vector<long long> fee(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                minutes[i] = BillingEngine::stayMinutes(entry[i], exit[i]);
+                const Tariff &t = billing.tariffFor(types[i]);
+                grace[i] = t.graceMinutes;
+                first[i] = t.firstHour;
+                perHour[i] = t.perHour;
+                cap[i] = t.dailyCap;
+            }
+            BillingEngine::feeColumn(minutes.data(), grace.data(), first.data(), perHour.data(),
+                                     cap.data(), fee.data(), n);
+            map<string, pair<int, long long>> perVehicle;
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto &acc = perVehicle[plates[i]];
+                acc.first++;
+                acc.second += fee[i];
+                grandTotal += fee[i];
+            }
+            for (auto &v : perVehicle)
+                f << kv.first << ',' << v.first << ',' << v.second.first << ',' << v.second.second << "\n";
+            totalSessions += n;
+        }
+        cout << "Billed " << totalSessions << " session(s), total " << grandTotal
+             << ". Invoice written to " << out << "\n";
+    }
+
+    void findParkedPlate()
+    {
+        cout << "License Plate: ";
+        string plate;
+        getline(cin, plate);
+        auto it = nodes.find(plates.lotOf(normalizePlate(plate)));
+        if (it == nodes.end())
+        {
+            cout << "Not parked in any lot\n";
+            return;
+        }
+        ParkingLot *lot = it->second;
+        lock_guard<mutex> lk(lot->mtx);
+        int sid = lot->sessionOfPlate(plate);
+        cout << plate << " is parked in " << lot->lotId << " (" << lot->name << "), spot "
+             << lot->spotOfSession(sid) << ", session " << sid << "\n";
+    }
+
+    // Resolves a possibly misread plate to registered vehicles within two
+    // edits; candidates whose vehicle has since gone are dropped here
+    void resolvePlate()
+    {
+        cout << "Plate as read: ";
+        string plate;
+        getline(cin, plate);
+        auto found = plateMatcher.match(plate);
+        int shown = 0;
+        for (auto &c : found)
+        {
+            auto it = nodes.find(c.lotId);
+            string type;
+            if (it != nodes.end())
+            {
+                lock_guard<mutex> lk(it->second->mtx);
+                type = it->second->vehicleType(c.plate);
+            }
+            if (type.empty())
+            {
+                plateMatcher.forget(c.plate, c.lotId);
+                continue;
+            }
+            if (shown++ == 10)
+                break;
+            cout << c.plate << " (" << type << ") in " << c.lotId << ", distance " << c.distance << "\n";
+        }
+        if (!shown)
+            cout << "No registered plate within 2 edits\n";
+    }
+
+    // Up to k lots nearest to `from` (excluding itself) with a free `type`
+    // spot, as (lot, distance); Dijkstra stops once k matches are settled
+    vector<pair<string, int>> nearestWithFreeSpot(const string &from, const string &type, size_t k)
+    {
+        vector<pair<string, int>> found;
+        unordered_map<string, int> dist;
+        priority_queue<pair<int, string>, vector<pair<int, string>>, greater<pair<int, string>>> pq;
+        dist[from] = 0;
+        pq.push({0, from});
+        while (!pq.empty() && found.size() < k)
+        {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > dist[u])
+                continue;
+            auto lot = nodes.find(u);
+            if (u != from && lot != nodes.end() && lot->second->freeSpotCount(type) > 0)
+                found.push_back({u, d});
+            auto it = adj.find(u);
+            if (it == adj.end())
+                continue;
+            for (auto &e : it->second)
+            {
+                auto cur = dist.find(e.first);
+                if (cur == dist.end() || d + e.second < cur->second)
+                {
+                    dist[e.first] = d + e.second;
+                    pq.push({d + e.second, e.first});
+                }
+            }
+        }
+        return found;
+    }
+
+    // Occupancy curves per lot, computed on parallel worker threads, plus a
+    // network curve summed from the lots' closing occupancy per bucket
+    void analyzeOccupancy()
+    {
+        time_t t = time(0);
+        string nowText = ctime(&t);
+        long long now = parseTimestamp(nowText);
+        vector<ParkingLot *> lots;
+        for (auto &kv : nodes)
+            lots.push_back(kv.second);
+        vector<ParkingLot::OccupancyReport> reports(lots.size());
+
+        atomic<size_t> nextLot{0};
+        unsigned workers = max(1u, min<unsigned>(thread::hardware_concurrency(), lots.size()));
+        vector<thread> pool;
+        for (unsigned w = 0; w < workers; ++w)
+            pool.emplace_back([&]()
+                              {
+                for (size_t i; (i = nextLot++) < lots.size();)
+                {
+                    reports[i] = lots[i]->computeOccupancy(now);
+                    writeOccupancyCsv("occupancy_" + lots[i]->lotId + ".csv", reports[i]);
+                } });
+        for (auto &th : pool)
+            th.join();
+
+        // The network curve is its own sweep over every lot's events: summing
+        // per-lot peaks would add up maxima reached at different moments
+        ParkingLot::OccupancyReport network;
+        for (auto &r : reports)
+        {
+            size_t mid = network.events.size();
+            network.events.insert(network.events.end(), r.events.begin(), r.events.end());
+            inplace_merge(network.events.begin(), network.events.begin() + mid, network.events.end());
+            vector<pair<long long, int>>().swap(r.events);
+        }
+        ParkingLot::sweepBuckets(network, now);
+        writeOccupancyCsv("occupancy_network.csv", network);
+
+        cout << "-- Occupancy (" << ParkingLot::BUCKET_SECONDS / 60 << "-minute buckets) --\n";
+        for (size_t i = 0; i < lots.size(); ++i)
+        {
+            auto &r = reports[i];
+            cout << lots[i]->lotId << ": peak " << r.maxOccupancy;
+            if (r.maxAt >= 0)
+                cout << " at " << formatTimestamp(r.maxAt);
+            cout << "\n";
+            for (auto &d : r.dwell)
+                cout << "  avg dwell (" << (d.first.empty() ? "?" : d.first) << "): "
+                     << d.second.first / d.second.second / 60 << " min over "
+                     << d.second.second << " stay(s)\n";
+        }
+        cout << "Wrote occupancy_<lot>.csv for each lot and occupancy_network.csv\n";
+    }
+
     void manageParkingLot()
     {
         cout << "Parking Lot ID: ";
@@ -572,9 +2504,13 @@ public:
                  << "10. Delete Vehicle\n"
                  << "11. Delete Spot\n"
                  << "12. Delete Session\n"
-                 << "13. Go Back\n";
-            int c = readInt("Choose: ", 1, 13);
-            if (c == 13)
+                 << "13. Start Session (Any Free Spot)\n"
+                 << "14. Reserve Spot\n"
+                 << "15. Cancel Reservation\n"
+                 << "16. Check Availability\n"
+                 << "17. Go Back\n";
+            int c = readInt("Choose: ", 1, 17);
+            if (c == 17)
                 break;
             switch (c)
             {
@@ -617,6 +2553,8 @@ public:
                     cout << "Invalid IDs\n";
                 else if (id == -2)
                     cout << "Spot occupied\n";
+                else if (id == -5)
+                    cout << "Spot reserved\n";
                 else
                     cout << "Session started: " << id << "\n";
                 break;
@@ -627,8 +2565,9 @@ public:
                 time_t now = time(0);
                 string exit = ctime(&now);
                 exit.erase(exit.find('\n'));
+                long long fee = lot->quoteFee(sid, parseTimestamp(exit), billing);
                 if (lot->endParkingSession(sid, exit))
-                    cout << "Session ended\n";
+                    cout << "Session ended" << (fee >= 0 ? ", fee: " + to_string(fee) : "") << "\n";
                 else
                     cout << "Invalid session or already ended\n";
                 break;
@@ -681,6 +2620,73 @@ public:
                     cout << "Delete failed\n";
                 break;
             }
+            case 13:
+            {
+                cout << "Vehicle License: ";
+                string vId;
+                getline(cin, vId);
+                cout << "Spot Type: ";
+                string t;
+                getline(cin, t);
+                time_t now = time(0);
+                string entry = ctime(&now);
+                entry.erase(entry.find('\n'));
+                int id = lot->startSessionAnySpot(vId, t, entry);
+                if (id == -1)
+                    cout << "Unknown vehicle\n";
+                else if (id == -3)
+                {
+                    cout << "No free " << t << " spot\n";
+                    auto alt = nearestWithFreeSpot(lid, t, 3);
+                    for (auto &a : alt)
+                        cout << "  Try " << a.first << " (" << nodes[a.first]->name
+                             << ", " << a.second << "m)\n";
+                }
+                else
+                    cout << "Session started: " << id << " at spot "
+                         << lot->spotOfSession(id) << "\n";
+                break;
+            }
+            case 14:
+            {
+                cout << "Vehicle License: ";
+                string vId;
+                getline(cin, vId);
+                cout << "Spot Type: ";
+                string t;
+                getline(cin, t);
+                long long from, to;
+                if (!readWindow(from, to))
+                    break;
+                int rid = lot->reserveSpot(vId, t, from, to);
+                if (rid == -1)
+                    cout << "Unknown vehicle or invalid window\n";
+                else if (rid == -3)
+                    cout << "No " << t << " spot free for that window\n";
+                else
+                    cout << "Reservation " << rid << " booked\n";
+                break;
+            }
+            case 15:
+            {
+                lot->displayReservations();
+                int rid = readInt("Reservation ID: ", 1);
+                if (lot->cancelReservation(rid))
+                    cout << "Reservation cancelled\n";
+                else
+                    cout << "No such reservation\n";
+                break;
+            }
+            case 16:
+            {
+                cout << "Spot Type: ";
+                string t;
+                getline(cin, t);
+                long long from, to;
+                if (readWindow(from, to))
+                    cout << lot->availableSpots(t, from, to) << " " << t << " spot(s) available\n";
+                break;
+            }
             }
         }
     }
@@ -688,6 +2694,90 @@ public:
 private:
     string genId() { return "L" + to_string(nextLotIndex++); }
 
+    static bool readWindow(long long &from, long long &to)
+    {
+        string a, b;
+        cout << "From (YYYY-MM-DD HH:MM): ";
+        getline(cin, a);
+        cout << "To (YYYY-MM-DD HH:MM): ";
+        getline(cin, b);
+        from = parseDateTime(a);
+        to = parseDateTime(b);
+        if (from < 0 || to <= from)
+        {
+            cout << "Invalid time window\n";
+            return false;
+        }
+        return true;
+    }
+
+    // One worker's share of a batch: apply in order, then commit its lots
+    IngestStats applyShard(const vector<string> &lines)
+    {
+        IngestStats st;
+        vector<ParkingLot *> touched;
+        for (auto &line : lines)
+            if (applyGateEvent(line, touched))
+                st.applied++;
+            else
+                st.rejected++;
+        for (auto *lot : touched)
+            lot->commitBatch();
+        return st;
+    }
+
+    // Applies one gate event
+    bool applyGateEvent(const string &line, vector<ParkingLot *> &touched)
+    {
+        vector<string> c;
+        stringstream ss(line);
+        string tok;
+        while (getline(ss, tok, ','))
+            c.push_back(tok);
+        if (c.size() < 4)
+            return false;
+        auto it = nodes.find(c[1]);
+        if (it == nodes.end())
+            return false;
+        ParkingLot *lot = it->second;
+
+        const string &ts = c[3];
+        long long secs = -1;
+        if (!ts.empty() && all_of(ts.begin(), ts.end(), ::isdigit))
+        {
+            // An out-of-range epoch rejects the line rather than throwing in a worker
+            errno = 0;
+            char *end;
+            long long epoch = strtoll(ts.c_str(), &end, 10);
+            if (errno == ERANGE || *end)
+                return false;
+            secs = localWallSeconds(epoch);
+        }
+        else
+            secs = parseTimestamp(ts);
+        if (secs < 0)
+            return false;
+        string when = formatCtime(secs);
+
+        if (lot->beginBatch())
+            touched.push_back(lot);
+        string dir = toLowerStr(c[2]);
+        if (dir == "in")
+            return lot->gateEnter(c[0], c.size() > 4 ? c[4] : "", when) > 0;
+        if (dir == "out")
+            return lot->gateExit(c[0], when);
+        return false;
+    }
+
+    static void writeOccupancyCsv(const string &fn, const ParkingLot::OccupancyReport &r)
+    {
+        ofstream f(fn);
+        f << "bucket_start,peak_occupancy,occupancy_at_end\n";
+        for (size_t b = 0; b < r.atEnd.size(); ++b)
+            f << formatTimestamp((r.firstBucket + b) * ParkingLot::BUCKET_SECONDS) << ','
+              << r.peak[b] << ',' << r.atEnd[b] << "\n";
+    }
+
     void loadLots()
     {
         ifstream f("parking_lots.csv");
@@ -705,6 +2795,7 @@ private:
             getline(ss, loc, ',');
             maxIdx = max(maxIdx, stoi(id.substr(1)));
             nodes[id] = new ParkingLot(id, nm, loc);
+            nodes[id]->attachIndexes(&plates, &plateMatcher);
         }
         nextLotIndex = maxIdx + 1;
     }
@@ -759,10 +2850,296 @@ private:
     }
 };
 
+// ======== Simulator ========
+// Discrete-event load test: Poisson arrivals per lot, lognormal dwell times
+// per spot type, drivers diverted to the nearest lot with room when turned
+// away, and plate lookups mixed in. Runs against a scratch network, so
+// nothing on disk is touched, and times every call into PMS.
+struct SimConfig
+{
+    int lots = 20;
+    int days = 7;
+    double arrivalsPerHour = 40; // per lot
+    unsigned seed = 1;
+    double lookupShare = 0.1; // arrivals that also trigger a find + fuzzy resolve
+};
+
+class Simulator
+{
+public:
+    explicit Simulator(const SimConfig &c) : cfg(c), rng(c.seed), net(false) {}
+
+    void run()
+    {
+        buildNetwork();
+        time_t now = time(0);
+        start = parseTimestamp(ctime(&now));
+        start -= start % 86400;
+        long long end = start + cfg.days * 86400LL;
+        for (int l = 0; l < cfg.lots; ++l)
+            events.push({start + nextGap(), ARRIVE, l, -1});
+
+        auto wall = chrono::steady_clock::now();
+        long long processed = 0;
+        while (!events.empty() && events.top().at < end)
+        {
+            Event e = events.top();
+            events.pop();
+            ++processed;
+            if (e.kind == ARRIVE)
+            {
+                arrive(e.lot, e.at);
+                events.push({e.at + nextGap(), ARRIVE, e.lot, -1});
+            }
+            else
+                depart(e.plate, e.at);
+        }
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - wall).count();
+        report(processed, secs);
+    }
+
+private:
+    enum Kind
+    {
+        ARRIVE,
+        DEPART
+    };
+    struct Event
+    {
+        long long at;
+        Kind kind;
+        int lot, plate;
+        bool operator>(const Event &o) const { return at > o.at; }
+    };
+    struct SpotMix
+    {
+        const char *type;
+        int spots;
+        double share, dwellHours, sigma;
+    };
+    static constexpr int MIX_SIZE = 3;
+    static constexpr SpotMix MIX[MIX_SIZE] = {{"car", 120, 0.75, 2.0, 0.9},
+                                       {"bike", 30, 0.15, 1.5, 0.7},
+                                       {"truck", 15, 0.10, 4.0, 0.6}};
+    enum Op
+    {
+        OP_ENTER,
+        OP_EXIT,
+        OP_NEAREST,
+        OP_FIND,
+        OP_RESOLVE,
+        OP_COUNT
+    };
+
+    SimConfig cfg;
+    mt19937_64 rng;
+    ParkingNetwork net;
+    vector<string> lotIds;
+    vector<string> fleet;     // plates
+    vector<int> fleetType;    // index into MIX
+    vector<int> parkedAt;     // lot index, or -1
+    priority_queue<Event, vector<Event>, greater<Event>> events;
+    long long start = 0;
+    vector<long long> latency[OP_COUNT]; // ns per call
+    long long arrivals = 0, admitted = 0, diverted = 0, turnedAway = 0, noDriver = 0, resolved = 0;
+
+    void buildNetwork()
+    {
+        for (int l = 0; l < cfg.lots; ++l)
+        {
+            string id = net.createLot("Sim " + to_string(l + 1), "Zone " + to_string(l % 5 + 1));
+            lotIds.push_back(id);
+            for (auto &m : MIX)
+                for (int k = 0; k < m.spots; ++k)
+                    net.nodes[id]->addParkingSpot(m.type);
+        }
+        uniform_int_distribution<int> meters(200, 2000);
+        for (int l = 0; l < cfg.lots; ++l)
+        {
+            if (cfg.lots > 1)
+                net.link(lotIds[l], lotIds[(l + 1) % cfg.lots], meters(rng));
+            if (cfg.lots > 3)
+                net.link(lotIds[l], lotIds[(l + cfg.lots / 2) % cfg.lots], 2 * meters(rng));
+        }
+
+        // Three drivers per spot, with UK-style plates so the fuzzy index sees real shapes
+        static const char *LETTERS = "ABCDEFGHJKLMNOPRSTUVWXYZ";
+        uniform_int_distribution<int> letter(0, 23), digit(0, 9);
+        uniform_real_distribution<double> unit(0, 1);
+        unordered_set<string> seen;
+        for (int i = 0; i < MIX_SIZE; ++i)
+            for (int n = 0; n < 3 * MIX[i].spots * cfg.lots; ++n)
+            {
+                string p;
+                do
+                {
+                    p = {LETTERS[letter(rng)], LETTERS[letter(rng)], char('0' + digit(rng)),
+                         char('0' + digit(rng)), LETTERS[letter(rng)], LETTERS[letter(rng)],
+                         LETTERS[letter(rng)]};
+                } while (!seen.insert(p).second);
+                fleet.push_back(p);
+                fleetType.push_back(i);
+            }
+        parkedAt.assign(fleet.size(), -1);
+    }
+
+    long long nextGap()
+    {
+        exponential_distribution<double> gap(cfg.arrivalsPerHour / 3600.0);
+        return max(1LL, (long long)gap(rng));
+    }
+
+    int pickType()
+    {
+        double r = uniform_real_distribution<double>(0, 1)(rng);
+        for (int i = 0; i < MIX_SIZE; ++i)
+            if ((r -= MIX[i].share) < 0)
+                return i;
+        return 0;
+    }
+
+    // Random idle driver of the type; after a few misses the arrival is dropped
+    // and counted as noDriver, so it is not mistaken for a full network
+    int pickDriver(int type)
+    {
+        uniform_int_distribution<size_t> any(0, fleet.size() - 1);
+        for (int tries = 0; tries < 16; ++tries)
+        {
+            size_t i = any(rng);
+            if (fleetType[i] == type && parkedAt[i] < 0)
+                return i;
+        }
+        return -1;
+    }
+
+    template <class F>
+    auto timed(Op op, F f) -> decltype(f())
+    {
+        auto t = chrono::steady_clock::now();
+        auto r = f();
+        latency[op].push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - t).count());
+        return r;
+    }
+
+    void arrive(int lot, long long at)
+    {
+        ++arrivals;
+        int type = pickType();
+        int d = pickDriver(type);
+        if (d < 0)
+        {
+            ++noDriver;
+            return;
+        }
+        const string &plate = fleet[d];
+        string when = formatCtime(at);
+        const string kind = MIX[type].type;
+        ParkingLot *target = net.nodes[lotIds[lot]];
+        int sid = timed(OP_ENTER, [&]
+                        { return target->gateEnter(plate, kind, when); });
+        int at_lot = lot;
+        if (sid == -3)
+        {
+            auto alt = timed(OP_NEAREST, [&]
+                             { return net.nearestWithFreeSpot(lotIds[lot], kind, 3); });
+            if (alt.empty())
+            {
+                ++turnedAway;
+                return;
+            }
+            ++diverted;
+            target = net.nodes[alt.front().first];
+            at_lot = find(lotIds.begin(), lotIds.end(), alt.front().first) - lotIds.begin();
+            sid = timed(OP_ENTER, [&]
+                        { return target->gateEnter(plate, kind, when); });
+        }
+        if (sid < 0)
+        {
+            ++turnedAway;
+            return;
+        }
+        ++admitted;
+        parkedAt[d] = at_lot;
+        lognormal_distribution<double> dwell(log(MIX[type].dwellHours * 3600.0) - MIX[type].sigma * MIX[type].sigma / 2,
+                                             MIX[type].sigma);
+        events.push({at + max(60LL, (long long)dwell(rng)), DEPART, at_lot, d});
+
+        if (uniform_real_distribution<double>(0, 1)(rng) < cfg.lookupShare)
+            lookups();
+    }
+
+    void depart(int d, long long at)
+    {
+        ParkingLot *lot = net.nodes[lotIds[parkedAt[d]]];
+        string when = formatCtime(at);
+        timed(OP_EXIT, [&]
+              { return lot->gateExit(fleet[d], when); });
+        parkedAt[d] = -1;
+    }
+
+    // Look up a random fleet plate, then resolve it with one character misread
+    void lookups()
+    {
+        uniform_int_distribution<size_t> any(0, fleet.size() - 1);
+        string plate = fleet[any(rng)];
+        timed(OP_FIND, [&]
+              { return net.plates.lotOf(plate); });
+        plate[uniform_int_distribution<size_t>(0, plate.size() - 1)(rng)] = '8';
+        auto hits = timed(OP_RESOLVE, [&]
+                          { return net.plateMatcher.match(plate); });
+        resolved += !hits.empty();
+    }
+
+    void report(long long processed, double secs)
+    {
+        static const char *NAMES[OP_COUNT] = {"gate enter", "gate exit", "nearest lot", "find plate", "resolve plate"};
+        cout << "Simulated " << cfg.days << " day(s), " << cfg.lots << " lots, "
+             << fleet.size() << " drivers in " << secs << " s ("
+             << (long long)(processed / max(secs, 1e-9)) << " events/s)\n"
+             << "Arrivals " << arrivals << ", admitted " << admitted << ", diverted " << diverted
+             << ", turned away " << turnedAway << ", no idle driver " << noDriver
+             << ", fuzzy hits " << resolved << "\n";
+        printf("%-13s %7s %9s %9s %9s %9s\n", "operation", "calls", "ops/s", "p50 us", "p95 us", "p99 us");
+        for (int op = 0; op < OP_COUNT; ++op)
+        {
+            vector<long long> &v = latency[op];
+            if (v.empty())
+                continue;
+            long long total = 0;
+            for (long long ns : v)
+                total += ns;
+            sort(v.begin(), v.end());
+            auto pct = [&](double q)
+            { return v[min(v.size() - 1, (size_t)(q * v.size()))] / 1000.0; };
+            printf("%-13s %7zu %9.0f %9.1f %9.1f %9.1f\n", NAMES[op], v.size(),
+                   v.size() / max(total / 1e9, 1e-9), pct(0.50), pct(0.95), pct(0.99));
+        }
+    }
+};
+
 // ======== Main Function ========
-int main()
+int main(int argc, char **argv)
 {
+    // Load test on scratch lots: pvms --simulate [lots] [days] [seed]
+    if (argc >= 2 && string(argv[1]) == "--simulate")
+    {
+        SimConfig cfg;
+        if (argc > 2)
+            cfg.lots = max(1, atoi(argv[2]));
+        if (argc > 3)
+            cfg.days = max(1, atoi(argv[3]));
+        if (argc > 4)
+            cfg.seed = strtoul(argv[4], nullptr, 10);
+        Simulator(cfg).run();
+        return 0;
+    }
     ParkingNetwork pn;
+    // Headless mode for gate feeds: pvms --ingest <file-or-fifo> [--dashboard]
+    if ((argc == 3 || argc == 4) && string(argv[1]) == "--ingest")
+    {
+        pn.ingestFile(argv[2], argc == 4 && string(argv[3]) == "--dashboard");
+        return 0;
+    }
     while (true)
     {
         cout << "\n=== Parking Management System ===\n"
@@ -773,9 +3150,15 @@ int main()
              << "5. List Parking Lots\n"
              << "6. Display Network\n"
              << "7. Delete Parking Lot\n"
-             << "8. Exit\n";
-        int choice = readInt("Choose: ", 1, 8);
-        if (choice == 8)
+             << "8. Monthly Billing Run\n"
+             << "9. Occupancy Analytics\n"
+             << "10. Ingest Gate Events\n"
+             << "11. Find Parked Plate\n"
+             << "12. Resolve Plate (fuzzy)\n"
+             << "13. Live Dashboard\n"
+             << "14. Exit\n";
+        int choice = readInt("Choose: ", 1, 14);
+        if (choice == 14)
             break;
         switch (choice)
         {
@@ -800,6 +3183,29 @@ int main()
         case 7:
             pn.deleteParkingLot();
             break;
+        case 8:
+            pn.runBilling();
+            break;
+        case 9:
+            pn.analyzeOccupancy();
+            break;
+        case 10:
+        {
+            cout << "Event file or pipe: ";
+            string path;
+            getline(cin, path);
+            pn.ingestFile(path);
+            break;
+        }
+        case 11:
+            pn.findParkedPlate();
+            break;
+        case 12:
+            pn.resolvePlate();
+            break;
+        case 13:
+            pn.showDashboard();
+            break;
         }
     }
     cout << "Goodbye!\n";
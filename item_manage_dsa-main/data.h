@@ -13,6 +13,18 @@ struct Item
     string regDate;
 };
 
+// Options of `itemslist`; unset ranges and an empty prefix match everything
+struct ItemFilter
+{
+    bool hasQuantity = false;
+    int minQuantity = 0, maxQuantity = 0;
+    bool hasDate = false;
+    int fromDate = 0, toDate = 0; // yyyymmdd
+    string prefix;                // lower-cased
+    string sortBy = "name";       // name, qty, date or id
+    bool descending = false;
+};
+
 // Declare as extern so it can be defined in a single .cpp file
 extern string filename;
 
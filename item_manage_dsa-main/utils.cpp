@@ -3,6 +3,184 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <cstdio>
+#include <sys/stat.h>
+
+// In-memory copy of the items file, sorted by name. It is loaded on the first
+// itemslist, kept in step by addItem, and reloaded only when the file's
+// modification time or size shows that someone else changed it.
+struct ItemCache
+{
+    bool loaded = false;
+    time_t mtime = 0;
+    long long size = -1;
+    vector<Item> items;     // in file order
+    vector<string> keys;    // lower-cased names, parallel to items
+    vector<size_t> byName;  // positions in items, by key then file order
+
+    // Range indexes, built by the first query that needs them and then kept
+    // in step like byName
+    bool hasRangeIndexes = false;
+    vector<int> dates;          // regDate as yyyymmdd (-1 if invalid), parallel to items
+    vector<size_t> byQuantity;  // positions by quantity, then file order
+    vector<size_t> byDate;      // positions by date, then file order
+};
+
+static ItemCache cache;
+
+static bool fileStamp(time_t &mtime, long long &size)
+{
+    struct stat st;
+    if (stat(filename.c_str(), &st) != 0)
+    {
+        return false;
+    }
+    mtime = st.st_mtime;
+    size = st.st_size;
+    return true;
+}
+
+static bool cacheIsCurrent()
+{
+    time_t mtime;
+    long long size;
+    return cache.loaded && fileStamp(mtime, size) && mtime == cache.mtime && size == cache.size;
+}
+
+struct ByKey
+{
+    bool operator()(size_t a, size_t b) const { return cache.keys[a] < cache.keys[b]; }
+};
+
+struct ByQuantity
+{
+    bool operator()(size_t a, size_t b) const { return cache.items[a].quantity < cache.items[b].quantity; }
+    bool operator()(size_t a, int q) const { return cache.items[a].quantity < q; }
+    bool operator()(int q, size_t a) const { return q < cache.items[a].quantity; }
+};
+
+struct ByDate
+{
+    bool operator()(size_t a, size_t b) const { return cache.dates[a] < cache.dates[b]; }
+    bool operator()(size_t a, int d) const { return cache.dates[a] < d; }
+    bool operator()(int d, size_t a) const { return d < cache.dates[a]; }
+};
+
+struct ById
+{
+    bool operator()(size_t a, size_t b) const { return cache.items[a].id < cache.items[b].id; }
+};
+
+// Compares only the first prefix.size() characters of a key
+struct ByPrefix
+{
+    bool operator()(size_t a, const string &prefix) const { return cache.keys[a].compare(0, prefix.size(), prefix) < 0; }
+    bool operator()(const string &prefix, size_t a) const { return cache.keys[a].compare(0, prefix.size(), prefix) > 0; }
+};
+
+// Sorts (value, position) pairs rather than positions through a comparator,
+// which keeps the sort in cache; ties end up in file order
+static void sortedPositions(vector<pair<int, size_t> > &keyed, vector<size_t> &index)
+{
+    sort(keyed.begin(), keyed.end());
+    index.resize(keyed.size());
+    for (size_t i = 0; i < keyed.size(); i++)
+    {
+        index[i] = keyed[i].second;
+    }
+}
+
+static void buildRangeIndexes()
+{
+    size_t n = cache.items.size();
+    vector<pair<int, size_t> > quantities(n), dates(n);
+    cache.dates.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        cache.dates[i] = dateKey(cache.items[i].regDate);
+        quantities[i] = make_pair(cache.items[i].quantity, i);
+        dates[i] = make_pair(cache.dates[i], i);
+    }
+    sortedPositions(quantities, cache.byQuantity);
+    sortedPositions(dates, cache.byDate);
+    cache.hasRangeIndexes = true;
+}
+
+static void storeItem(const Item &item)
+{
+    cache.items.push_back(item);
+    cache.keys.push_back(toLowerCase(item.name));
+}
+
+// Appended items go after any equal names, like a stable sort would put them
+static void indexItem(const Item &item)
+{
+    storeItem(item);
+    size_t pos = cache.items.size() - 1;
+    cache.byName.insert(upper_bound(cache.byName.begin(), cache.byName.end(), pos, ByKey()), pos);
+    if (cache.hasRangeIndexes)
+    {
+        cache.dates.push_back(dateKey(item.regDate));
+        cache.byQuantity.insert(upper_bound(cache.byQuantity.begin(), cache.byQuantity.end(), pos, ByQuantity()), pos);
+        cache.byDate.insert(upper_bound(cache.byDate.begin(), cache.byDate.end(), pos, ByDate()), pos);
+    }
+}
+
+// id,name,quantity,date; false for blank or malformed lines
+static bool parseItem(const string &line, Item &item)
+{
+    size_t a = line.find(',');
+    size_t b = a == string::npos ? a : line.find(',', a + 1);
+    size_t c = b == string::npos ? b : line.find(',', b + 1);
+    if (c == string::npos)
+    {
+        return false;
+    }
+    try
+    {
+        item.id = stoi(line.substr(0, a));
+        item.quantity = stoi(line.substr(b + 1, c - b - 1));
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+    item.name.assign(line, a + 1, b - a - 1);
+    item.regDate.assign(line, c + 1, line.find(',', c + 1) - c - 1);
+    return true;
+}
+
+// Reparses the file only if it changed since the cache was built
+static bool refreshCache()
+{
+    if (cacheIsCurrent())
+    {
+        return true;
+    }
+    ifstream file(filename);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    cache = ItemCache();
+    string line;
+    Item item;
+    while (getline(file, line))
+    {
+        if (parseItem(line, item))
+        {
+            storeItem(item);
+        }
+    }
+    cache.byName.resize(cache.items.size());
+    for (size_t i = 0; i < cache.byName.size(); i++)
+    {
+        cache.byName[i] = i;
+    }
+    stable_sort(cache.byName.begin(), cache.byName.end(), ByKey());
+    cache.loaded = fileStamp(cache.mtime, cache.size);
+    return true;
+}
 
 bool openFile(string filename)
 {
@@ -100,6 +278,8 @@ bool validateDate(const string &date)
 
 bool addItem(Item item)
 {
+    // Only a cache that matched the file before our append can take the new row
+    bool current = cacheIsCurrent();
     ofstream outputFile(filename, ios::app);
     if (!outputFile)
     {
@@ -107,54 +287,213 @@ bool addItem(Item item)
         return false; // Fixed: was returning 1
     }
     outputFile << item.id << "," << item.name << "," << item.quantity << "," << item.regDate << endl;
+    outputFile.close();
+    if (current)
+    {
+        indexItem(item);
+        cache.loaded = fileStamp(cache.mtime, cache.size);
+    }
+    else
+    {
+        cache.loaded = false;
+    }
     return true; // Added: return a proper value
 }
 
-void listItems()
+// dd-mm-yyyy -> yyyymmdd, or -1 if it does not parse
+int dateKey(const string &date)
 {
-    vector<Item> items;
-    ifstream file(filename);
+    int day, month, year;
+    if (sscanf(date.c_str(), "%d-%d-%d", &day, &month, &year) != 3)
+    {
+        return -1;
+    }
+    return year * 10000 + month * 100 + day;
+}
 
-    if (!file.is_open())
+// itemslist [qty <min> <max>] [date <from> <to>] [prefix <text>] [sort name|qty|date|id] [desc]
+bool parseItemFilter(istringstream &iss, ItemFilter &filter)
+{
+    string option;
+    while (iss >> option)
+    {
+        option = toLowerCase(option);
+        if (option == "qty")
+        {
+            if (!(iss >> filter.minQuantity >> filter.maxQuantity))
+            {
+                cout << "Error: qty needs a minimum and a maximum" << endl;
+                return false;
+            }
+            filter.hasQuantity = true;
+        }
+        else if (option == "date")
+        {
+            string from, to;
+            if (!(iss >> from >> to) || !validateDate(from) || !validateDate(to))
+            {
+                return false;
+            }
+            filter.fromDate = dateKey(from);
+            filter.toDate = dateKey(to);
+            filter.hasDate = true;
+        }
+        else if (option == "prefix")
+        {
+            if (!(iss >> filter.prefix))
+            {
+                cout << "Error: prefix needs some text" << endl;
+                return false;
+            }
+            filter.prefix = toLowerCase(filter.prefix);
+        }
+        else if (option == "sort")
+        {
+            iss >> filter.sortBy;
+            filter.sortBy = toLowerCase(filter.sortBy);
+            if (filter.sortBy != "name" && filter.sortBy != "qty" && filter.sortBy != "date" && filter.sortBy != "id")
+            {
+                cout << "Error: sort by name, qty, date or id" << endl;
+                return false;
+            }
+        }
+        else if (option == "desc")
+        {
+            filter.descending = true;
+        }
+        else
+        {
+            cout << "Error: unknown itemslist option '" << option << "'" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool matches(size_t pos, const ItemFilter &filter)
+{
+    const Item &item = cache.items[pos];
+    if (filter.hasQuantity && (item.quantity < filter.minQuantity || item.quantity > filter.maxQuantity))
+    {
+        return false;
+    }
+    if (filter.hasDate && (cache.dates[pos] < filter.fromDate || cache.dates[pos] > filter.toDate))
+    {
+        return false;
+    }
+    return cache.keys[pos].compare(0, filter.prefix.size(), filter.prefix) == 0;
+}
+
+typedef vector<size_t>::const_iterator Cursor;
+
+// Narrows [first, last) to the candidate range of another index if that one is smaller
+static void narrowTo(Cursor &first, Cursor &last, const vector<size_t> *&driver,
+                     const vector<size_t> &index, Cursor from, Cursor to)
+{
+    if (to - from < last - first)
+    {
+        first = from;
+        last = to;
+        driver = &index;
+    }
+}
+
+void listItems(const ItemFilter &filter)
+{
+    if (!refreshCache())
     {
         cerr << "Could not open the file " << filename << endl;
         exit(0);
     }
+    if ((filter.hasQuantity || filter.hasDate || filter.sortBy == "qty" || filter.sortBy == "date") &&
+        !cache.hasRangeIndexes)
+    {
+        buildRangeIndexes();
+    }
 
-    string line;
-    while (getline(file, line))
+    // Walk the smallest candidate range among the filters' indexes (or the
+    // sort order's own index), checking the other filters item by item
+    const vector<size_t> *sorted = &cache.byName;
+    if (filter.sortBy == "qty")
     {
-        istringstream iss(line);
-        string token;
-        Item item;
+        sorted = &cache.byQuantity;
+    }
+    else if (filter.sortBy == "date")
+    {
+        sorted = &cache.byDate;
+    }
+    const vector<size_t> *driver = sorted;
+    Cursor first = sorted->begin(), last = sorted->end();
+    if (!filter.prefix.empty())
+    {
+        narrowTo(first, last, driver, cache.byName,
+                 lower_bound(cache.byName.begin(), cache.byName.end(), filter.prefix, ByPrefix()),
+                 upper_bound(cache.byName.begin(), cache.byName.end(), filter.prefix, ByPrefix()));
+    }
+    if (filter.hasQuantity)
+    {
+        narrowTo(first, last, driver, cache.byQuantity,
+                 lower_bound(cache.byQuantity.begin(), cache.byQuantity.end(), filter.minQuantity, ByQuantity()),
+                 upper_bound(cache.byQuantity.begin(), cache.byQuantity.end(), filter.maxQuantity, ByQuantity()));
+    }
+    if (filter.hasDate)
+    {
+        narrowTo(first, last, driver, cache.byDate,
+                 lower_bound(cache.byDate.begin(), cache.byDate.end(), filter.fromDate, ByDate()),
+                 upper_bound(cache.byDate.begin(), cache.byDate.end(), filter.toDate, ByDate()));
+    }
 
-        if (getline(iss, token, ','))
+    vector<size_t> hits;
+    for (Cursor it = first; it < last; ++it)
+    {
+        if (matches(*it, filter))
         {
-            item.id = stoi(token);
+            hits.push_back(*it);
         }
-        if (getline(iss, token, ','))
+    }
+    // Only results drawn from another index (or sorted by ID) need sorting
+    if (driver != sorted || filter.sortBy == "id")
+    {
+        sort(hits.begin(), hits.end()); // file order, so ties stay in file order
+        if (filter.sortBy == "qty")
         {
-            item.name = token;
+            stable_sort(hits.begin(), hits.end(), ByQuantity());
         }
-        if (getline(iss, token, ','))
+        else if (filter.sortBy == "date")
         {
-            item.quantity = stoi(token);
+            stable_sort(hits.begin(), hits.end(), ByDate());
         }
-        if (getline(iss, token, ','))
+        else if (filter.sortBy == "id")
         {
-            item.regDate = token;
+            stable_sort(hits.begin(), hits.end(), ById());
         }
-
-        items.push_back(item);
+        else
+        {
+            stable_sort(hits.begin(), hits.end(), ByKey());
+        }
+    }
+    if (filter.descending)
+    {
+        reverse(hits.begin(), hits.end());
     }
-    file.close();
-    for (const auto &item : items)
+
+    // Streamed in 64 KB writes instead of a flush per line
+    string out;
+    for (size_t i = 0; i < hits.size(); i++)
     {
-        cout << "Item ID: " << item.id
-             << "\t Item Name: " << item.name
-             << "\t Quantity: " << item.quantity
-             << "\t Reg Date: " << item.regDate << endl;
+        const Item &item = cache.items[hits[i]];
+        out.append("Item ID: ").append(to_string(item.id));
+        out.append("\t Item Name: ").append(item.name);
+        out.append("\t Quantity: ").append(to_string(item.quantity));
+        out.append("\t Reg Date: ").append(item.regDate).append(1, '\n');
+        if (out.size() >= 65536)
+        {
+            cout.write(out.data(), out.size());
+            out.clear();
+        }
     }
+    cout.write(out.data(), out.size());
+    cout << hits.size() << " item(s)" << endl;
 }
 
 void help()
@@ -163,7 +502,10 @@ void help()
     cout << "*                 Command syntaxes                *" << endl;
     cout << "---------------------------------------------------" << endl;
     cout << "itemadd <item_id> <item_name> <quantity> <registration_date> - Adds an item\n";
-    cout << "itemslist - Lists all items\n";
+    cout << "itemslist - Lists all items, sorted by name\n";
+    cout << "  options: qty <min> <max>, date <from> <to>, prefix <text>,\n"
+         << "           sort name|qty|date|id, desc\n";
+    cout << "  e.g. itemslist qty 5 50 date 01-01-2025 31-12-2025 sort qty desc\n";
     cout << "help - Shows this help message\n";
 }
 
@@ -214,8 +556,14 @@ void processCommand(const string &input)
     }
     else if (cmd == "itemslist")
     {
-        cout << "Listing all items..." << endl;
-        listItems();
+        ItemFilter filter;
+        if (!parseItemFilter(iss, filter))
+        {
+            help();
+            return;
+        }
+        cout << "Listing items..." << endl;
+        listItems(filter);
     }
     else if (cmd == "help")
     {
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <sstream>
 #include "data.h"
 
 using namespace std;
@@ -13,7 +14,9 @@ vector<string> split(const string &str, char delimiter);
 bool isLeapYear(int year);
 bool validateDate(const string &date);
 bool addItem(Item item);
-void listItems();
+int dateKey(const string &date);
+bool parseItemFilter(istringstream &iss, ItemFilter &filter);
+void listItems(const ItemFilter &filter = ItemFilter());
 void help();
 string toLowerCase(const string &str);
 void processCommand(const string &input);
@@ -4,8 +4,17 @@
 #include <vector>
 #include <algorithm>
 #include <regex>
+#include <unordered_set>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
 
 #define FILE_NAME "items.csv"
+#define ID_INDEX_FILE "items.csv.ids"
+// Set to 0 to drop the Bloom filter; the first lookup then builds the exact ID set
+#define USE_BLOOM_FILTER 1
 
 using namespace std;
 
@@ -98,29 +107,275 @@ string convertToLowercase(const string &str)
     return lowercase_str;
 }
 
-// Check if item_id is unique in the file
-bool isUniqueId(int id)
+// IDs present in FILE_NAME. The sidecar (ID_INDEX_FILE) stores the IDs, a
+// Bloom filter and how many bytes of the file they cover, so after a restart
+// only lines appended since then - by us or any other process - are parsed.
+// A file that shrank or whose covered bytes changed is rescanned from scratch.
+class IdIndex
 {
-    ifstream file(FILE_NAME);
-    string line;
-    if (file.is_open())
+public:
+    void open()
     {
-        while (getline(file, line))
+        if (!loadSidecar())
         {
-            istringstream ss(line);
-            string file_id;
-            if (ss >> file_id)
+            reset();
+        }
+        if (catchUp() > 0)
+        {
+            save();
+        }
+    }
+
+    bool contains(int id)
+    {
+        catchUp();
+#if USE_BLOOM_FILTER
+        if (!bloomMayContain(id))
+        {
+            return false;
+        }
+#endif
+        buildSet();
+        return ids.count(id) > 0;
+    }
+
+    void save()
+    {
+        if (covered == savedCovered)
+        {
+            return;
+        }
+        string tmp = string(ID_INDEX_FILE) + ".tmp";
+        FILE *f = fopen(tmp.c_str(), "wb");
+        if (!f)
+        {
+            return;
+        }
+        uint64_t header[4] = {MAGIC, covered, coveredSum, bloom.size()};
+        fwrite(header, sizeof(header), 1, f);
+        fwrite(bloom.data(), sizeof(uint64_t), bloom.size(), f);
+        vector<int32_t> all(ids.begin(), ids.end());
+        all.insert(all.end(), unhashed.begin(), unhashed.end());
+        uint64_t n = all.size();
+        fwrite(&n, sizeof(n), 1, f);
+        if (n > 0)
+        {
+            fwrite(all.data(), sizeof(int32_t), n, f);
+        }
+        if (fclose(f) == 0 && rename(tmp.c_str(), ID_INDEX_FILE) == 0)
+        {
+            savedCovered = covered;
+        }
+    }
+
+private:
+    static const uint64_t MAGIC = 0x3158444931444932ULL;
+    uint64_t covered = 0;              // bytes of FILE_NAME already indexed
+    uint64_t coveredSum = 0;           // tailSum(covered) when it was indexed
+    uint64_t savedCovered = 0;         // covered as of the sidecar on disk
+    time_t seenMtime = 0;              // FILE_NAME stamp at the last catchUp()
+    uint64_t seenSize = 0;
+    unordered_set<int> ids;            // exact set; only built once needed
+    vector<int32_t> unhashed;          // IDs read from the sidecar, not yet in ids
+    vector<uint64_t> bloom;            // 10+ bits per ID, 7 probes
+    size_t count = 0;
+
+    void reset()
+    {
+        covered = 0;
+        savedCovered = UINT64_MAX;
+        ids.clear();
+        unhashed.clear();
+        count = 0;
+        struct stat st;
+        size_t expected = stat(FILE_NAME, &st) == 0 ? st.st_size / 16 : 0;
+        bloom.assign(bloomWords(expected), 0);
+    }
+
+    static size_t bloomWords(size_t n)
+    {
+        size_t words = 16;
+        while (words * 64 < n * 16)
+        {
+            words *= 2;
+        }
+        return words;
+    }
+
+    static uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        return x ^ (x >> 33);
+    }
+
+    void bloomAdd(int id)
+    {
+        uint64_t h = mix((uint32_t)id), step = (h >> 32) | 1, bits = bloom.size() * 64;
+        for (int i = 0; i < 7; i++, h += step)
+        {
+            bloom[(h % bits) / 64] |= 1ULL << (h % 64);
+        }
+    }
+
+    bool bloomMayContain(int id) const
+    {
+        uint64_t h = mix((uint32_t)id), step = (h >> 32) | 1, bits = bloom.size() * 64;
+        for (int i = 0; i < 7; i++, h += step)
+        {
+            if (!(bloom[(h % bits) / 64] >> (h % 64) & 1))
             {
-                if (stoi(file_id) == id)
-                {
-                    file.close();
-                    return false;
-                }
+                return false;
             }
         }
-        file.close();
+        return true;
     }
-    return true;
+
+    void addId(int id)
+    {
+        ids.insert(id);
+        count++;
+        if (count * 10 > bloom.size() * 64)
+        {
+            // Filter too full: resize it for the new count and refill it
+            buildSet();
+            bloom.assign(bloomWords(ids.size() * 2), 0);
+            for (int known : ids)
+            {
+                bloomAdd(known);
+            }
+        }
+        else
+        {
+            bloomAdd(id);
+        }
+    }
+
+    void buildSet()
+    {
+        if (unhashed.empty())
+        {
+            return;
+        }
+        ids.reserve(ids.size() + unhashed.size());
+        ids.insert(unhashed.begin(), unhashed.end());
+        unhashed.clear();
+        unhashed.shrink_to_fit();
+    }
+
+    // FNV-1a of the (up to) 64 bytes just before `end`, to notice rewrites
+    static uint64_t tailSum(uint64_t end)
+    {
+        uint64_t h = 1469598103934665603ULL;
+        ifstream file(FILE_NAME, ios::binary);
+        uint64_t start = end > 64 ? end - 64 : 0;
+        char buf[64];
+        file.seekg(start);
+        file.read(buf, end - start);
+        for (streamsize i = 0; i < file.gcount(); i++)
+        {
+            h = (h ^ (unsigned char)buf[i]) * 1099511628211ULL;
+        }
+        return h;
+    }
+
+    bool loadSidecar()
+    {
+        FILE *f = fopen(ID_INDEX_FILE, "rb");
+        if (!f)
+        {
+            return false;
+        }
+        uint64_t header[4], n = 0;
+        bool ok = fread(header, sizeof(header), 1, f) == 1 && header[0] == MAGIC && header[3] > 0;
+        if (ok)
+        {
+            bloom.resize(header[3]);
+            ok = fread(bloom.data(), sizeof(uint64_t), bloom.size(), f) == bloom.size() &&
+                 fread(&n, sizeof(n), 1, f) == 1;
+        }
+        if (ok)
+        {
+            unhashed.resize(n);
+            ok = n == 0 || fread(unhashed.data(), sizeof(int32_t), n, f) == n;
+        }
+        fclose(f);
+        struct stat st;
+        ok = ok && stat(FILE_NAME, &st) == 0 && (uint64_t)st.st_size >= header[1] &&
+             tailSum(header[1]) == header[2];
+        if (!ok)
+        {
+            return false;
+        }
+        covered = savedCovered = header[1];
+        coveredSum = header[2];
+        count = n;
+        return true;
+    }
+
+    // Indexes complete lines appended since the last call; returns bytes read
+    uint64_t catchUp()
+    {
+        struct stat st;
+        if (stat(FILE_NAME, &st) != 0)
+        {
+            return 0;
+        }
+        uint64_t size = st.st_size;
+        if (st.st_mtime == seenMtime && size == seenSize)
+        {
+            return 0;
+        }
+        seenMtime = st.st_mtime;
+        seenSize = size;
+        if (size < covered || (covered > 0 && tailSum(covered) != coveredSum))
+        {
+            reset();
+        }
+        if (size == covered)
+        {
+            return 0;
+        }
+        ifstream file(FILE_NAME, ios::binary);
+        file.seekg(covered);
+        string chunk(size - covered, '\0');
+        file.read(&chunk[0], chunk.size());
+        chunk.resize(file.gcount());
+        size_t end = chunk.rfind('\n');
+        if (end == string::npos)
+        {
+            seenSize = 0; // a writer is mid-line; pick it up next time
+            return 0;
+        }
+        const char *p = chunk.c_str(), *stop = p + end + 1;
+        while (p < stop)
+        {
+            char *after;
+            long id = strtol(p, &after, 10);
+            if (after != p)
+            {
+                addId((int)id);
+            }
+            p = (const char *)memchr(p, '\n', stop - p) + 1;
+        }
+        covered += end + 1;
+        coveredSum = tailSum(covered);
+        if (end + 1 < chunk.size())
+        {
+            seenSize = 0; // partial line left over: look again on the next call
+        }
+        return end + 1;
+    }
+};
+
+IdIndex idIndex;
+
+// Check if item_id is unique in the file
+bool isUniqueId(int id)
+{
+    return !idIndex.contains(id);
 }
 
 // Validate date format (YYYY-MM-DD)
@@ -134,6 +389,8 @@ int main()
 {
     string command, user_input;
 
+    idIndex.open();
+
     // Welcome message
     cout << "================================\n";
     cout << "Welcome to the Inventory Manager!\n";
@@ -144,7 +401,10 @@ int main()
     {
         // Enhanced prompt
         cout << "\nCommand (itemadd, itemslist, help, exit): ";
-        getline(cin, user_input);
+        if (!getline(cin, user_input))
+        {
+            break;
+        }
         istringstream ss(user_input);
         command.clear();
         ss >> command;
@@ -275,5 +535,6 @@ int main()
         }
     }
 
+    idIndex.save();
     return 0;
 }
\ No newline at end of file